@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <chrono>
+#include <stdint.h>
+
+#if defined _MSC_VER && !defined __clang__
+#include <intrin.h>
+#endif
+
+namespace mud
+{
+namespace bench
+{
+	inline uint64_t now()
+	{
+		using namespace std::chrono;
+		return uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+	}
+
+	// keeps the compiler from optimizing away a benchmarked result : the value is an input to an empty asm block it can't see through
+	template <class T>
+	inline void keep(const T& value)
+	{
+#if defined _MSC_VER && !defined __clang__
+		static const volatile void* sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	// best of a few runs of a function returning its duration in nanoseconds
+	template <class F>
+	uint64_t best_of(uint32_t runs, F run)
+	{
+		uint64_t best = UINT64_MAX;
+		for(uint32_t i = 0; i < runs; ++i)
+		{
+			const uint64_t time = run();
+			best = time < best ? time : best;
+		}
+		return best;
+	}
+
+	// writes results as a JSON document to the file given with --out, or to bench_<name>.json, and a readable summary to stderr
+	// stdout is left alone, since the libraries log there
+	//   { "bench": "jobs", "results": [ { "name": "...", "threads": 4, "iterations": 1000, "ns_per_op": 12.5, ... }, ... ] }
+	class Report
+	{
+	public:
+		Report(const char* bench, int argc, char** argv)
+		{
+			char path[256];
+			snprintf(path, sizeof(path), "bench_%s.json", bench);
+			for(int i = 1; i < argc - 1; ++i)
+				if(strcmp(argv[i], "--out") == 0)
+					snprintf(path, sizeof(path), "%s", argv[i + 1]);
+
+			m_file = fopen(path, "w");
+			if(!m_file)
+			{
+				fprintf(stderr, "ERROR: could not open %s\n", path);
+				exit(1);
+			}
+			fprintf(m_file, "{\n\t\"bench\": \"%s\",\n\t\"results\": [", bench);
+		}
+
+		~Report()
+		{
+			fprintf(m_file, "\n\t]\n}\n");
+			fclose(m_file);
+		}
+
+		static uint32_t arg(int argc, char** argv, const char* name, uint32_t value)
+		{
+			for(int i = 1; i < argc - 1; ++i)
+				if(strcmp(argv[i], name) == 0)
+					return uint32_t(atoi(argv[i + 1]));
+			return value;
+		}
+
+		// an extra metric can be added to each result, like a speedup or a throughput
+		void add(const char* name, uint32_t threads, uint64_t iterations, uint64_t time, const char* metric = nullptr, double value = 0.0)
+		{
+			const double ns_per_op = iterations ? double(time) / double(iterations) : 0.0;
+			fprintf(m_file, "%s\n\t\t{ \"name\": \"%s\", \"threads\": %u, \"iterations\": %llu, \"ns\": %llu, \"ns_per_op\": %.3f",
+					m_count++ ? "," : "", name, threads, (unsigned long long)iterations, (unsigned long long)time, ns_per_op);
+			if(metric)
+				fprintf(m_file, ", \"%s\": %.3f", metric, value);
+			fprintf(m_file, " }");
+			fflush(m_file);
+
+			fprintf(stderr, "%-32s threads %2u  %12.3f ns/op", name, threads, ns_per_op);
+			if(metric)
+				fprintf(stderr, "  %s %.3f", metric, value);
+			fprintf(stderr, "\n");
+		}
+
+	private:
+		FILE* m_file = nullptr;
+		uint32_t m_count = 0;
+	};
+}
+}
@@ -0,0 +1,164 @@
+#include <stl/vector.hpp>
+#include <stl/small_vector.hpp>
+#include <stl/string.hpp>
+#include <stl/memory.h>
+#include <bench/Bench.h>
+
+#include <cstdio>
+
+// usage : mud_containers_bench [--out bench_containers.json]
+
+using namespace mud;
+using namespace mud::bench;
+
+namespace
+{
+	constexpr uint32_t RUNS = 5;
+	constexpr uint64_t OPERATIONS = 1 << 18;
+
+	// allocator that counts the allocations of the containers it's given to
+	struct CountingAllocator
+	{
+		static uint64_t s_allocations;
+
+		static void* static_allocate(size_t bytes) { ++s_allocations; return operator new(bytes); }
+		static void static_deallocate(void* ptr, size_t) { operator delete(ptr); }
+	};
+
+	uint64_t CountingAllocator::s_allocations = 0;
+
+	template <class T>
+	using counted_vector = stl::vector<T, CountingAllocator>;
+
+	template <class T, size_t N>
+	using counted_small_vector = stl::small_vector<T, N, CountingAllocator>;
+
+	using counted_string = stl::basic_string<CountingAllocator>;
+
+	struct Light { float m_range; };
+	struct Node { uint32_t m_index; };
+
+	Light s_lights[8];
+
+	struct Result
+	{
+		uint64_t m_time;
+		double m_allocations;
+	};
+
+	// runs func OPERATIONS times, returns the best time and the allocations per operation
+	template <class F>
+	Result measure(F func)
+	{
+		uint64_t allocations = 0;
+		const uint64_t time = best_of(RUNS, [&]
+		{
+			const uint64_t before = CountingAllocator::s_allocations;
+			const uint64_t begin = now();
+			for(uint64_t i = 0; i < OPERATIONS; ++i)
+				func(uint32_t(i));
+			const uint64_t end = now();
+			allocations = CountingAllocator::s_allocations - before;
+			return end - begin;
+		});
+		return { time, double(allocations) / double(OPERATIONS) };
+	}
+
+	// the lights touching an item, gathered when the item is created : 0 to 4 of them
+	template <class T_Vector>
+	void item_lights(uint32_t i)
+	{
+		T_Vector lights;
+		for(uint32_t l = 0; l < i % 5; ++l)
+			lights.push_back(&s_lights[l]);
+		keep(lights.size());
+	}
+
+	// the children of a widget or a scene graph node, created with it : 1 to 4 of them
+	template <class T_Vector>
+	void graph_nodes(uint32_t i)
+	{
+		T_Vector nodes;
+		for(uint32_t n = 0; n <= i % 4; ++n)
+			nodes.push_back(make_unique<Node>(Node{ n }));
+		keep(nodes.size());
+	}
+
+	// the argument pointers of a reflected call : 1 to 6 of them
+	template <class T_Vector>
+	void call_args(uint32_t i)
+	{
+		T_Vector args;
+		args.resize(1 + i % 6, nullptr);
+		keep(args.size());
+	}
+
+	// labels and short names, like most of the ui text
+	void labels(uint32_t i)
+	{
+		static const char* names[] = { "OK", "Cancel", "Position", "Rotation", "Material", "Shadows", "Directional", "Metallic Map" };
+		counted_string label = names[i % 8];
+		counted_string copy = label;
+		keep(copy.size());
+	}
+
+	// shader defines, built by concatenation, or appended in place like program_defines
+	void defines_concat(uint32_t i)
+	{
+		static const char* options[] = { "SKELETON", "INSTANCING", "BILLBOARD", "QNORMALS" };
+		counted_string defines = "";
+		for(uint32_t o = 0; o < 4; ++o)
+			if(i & (1 << o))
+				defines += counted_string(options[o]) + ";";
+		defines += counted_string("MATERIAL_ALBEDO") + "=" + "1" + ";";
+		keep(defines.size());
+	}
+
+	void defines_append(uint32_t i)
+	{
+		static const char* options[] = { "SKELETON", "INSTANCING", "BILLBOARD", "QNORMALS" };
+		counted_string defines;
+		defines.reserve(256);
+		for(uint32_t o = 0; o < 4; ++o)
+			if(i & (1 << o))
+			{
+				defines += options[o];
+				defines += ";";
+			}
+		defines += "MATERIAL_ALBEDO";
+		defines += "=";
+		defines += "1";
+		defines += ";";
+		keep(defines.size());
+	}
+
+	void compare(Report& report, const char* name, const char* before_suffix, const char* after_suffix, Result before, Result after)
+	{
+		char before_name[64];
+		char after_name[64];
+		snprintf(before_name, sizeof(before_name), "%s_%s", name, before_suffix);
+		snprintf(after_name, sizeof(after_name), "%s_%s", name, after_suffix);
+		report.add(before_name, 1, OPERATIONS, before.m_time, "allocs_per_op", before.m_allocations);
+		report.add(after_name, 1, OPERATIONS, after.m_time, "allocs_per_op", after.m_allocations);
+	}
+}
+
+int main(int argc, char** argv)
+{
+	Report report("containers", argc, argv);
+
+	// an iteration builds and destroys one container
+	compare(report, "item_lights", "vector", "small_vector",
+			measure(item_lights<counted_vector<Light*>>), measure(item_lights<counted_small_vector<Light*, 4>>));
+	compare(report, "graph_nodes", "vector", "small_vector",
+			measure(graph_nodes<counted_vector<unique<Node>>>), measure(graph_nodes<counted_small_vector<unique<Node>, 4>>));
+	compare(report, "call_args", "vector", "small_vector",
+			measure(call_args<counted_vector<void*>>), measure(call_args<counted_small_vector<void*, 8>>));
+
+	const Result label = measure(labels);
+	report.add("labels_string", 1, OPERATIONS, label.m_time, "allocs_per_op", label.m_allocations);
+
+	compare(report, "defines", "concat", "append", measure(defines_concat), measure(defines_append));
+
+	return 0;
+}
@@ -0,0 +1,179 @@
+#include <stl/vector.hpp>
+#include <stl/string.h>
+#include <stl/unordered_map.hpp>
+#include <stl/flat_map.hpp>
+#include <bench/Bench.h>
+
+#include <cstdio>
+
+// usage : mud_hash_bench [--size max_size] [--out bench_hash.json]
+
+using namespace mud;
+using namespace mud::bench;
+
+namespace
+{
+	constexpr uint32_t RUNS = 5;
+	constexpr uint64_t OPERATIONS = 1 << 20;
+
+	uint64_t random(uint64_t& state)
+	{
+		// splitmix64
+		uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+		z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+		z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+		return z ^ (z >> 31);
+	}
+
+	// keys like shader version hashes, and like asset names
+	vector<uint64_t> integer_keys(uint32_t count, uint64_t seed)
+	{
+		vector<uint64_t> keys(count);
+		for(uint64_t& key : keys)
+			key = random(seed);
+		return keys;
+	}
+
+	vector<string> string_keys(uint32_t count, uint64_t seed)
+	{
+		vector<string> keys(count);
+		char name[64];
+		for(string& key : keys)
+		{
+			snprintf(name, sizeof(name), "models/props/prop_%llx", (unsigned long long)random(seed));
+			key = name;
+		}
+		return keys;
+	}
+
+	template <class T_Map, class T_Key>
+	uint64_t insert(const vector<T_Key>& keys)
+	{
+		return best_of(RUNS, [&]
+		{
+			uint64_t time = 0;
+			for(uint64_t done = 0; done < OPERATIONS; done += keys.size())
+			{
+				T_Map map;
+				const uint64_t begin = now();
+				for(const T_Key& key : keys)
+					map[key] = uint32_t(done);
+				time += now() - begin;
+				keep(map.size());
+			}
+			return time;
+		});
+	}
+
+	// looks up keys that are all in the map, or none of them
+	template <class T_Map, class T_Key>
+	uint64_t find(const vector<T_Key>& keys, const vector<T_Key>& lookups)
+	{
+		T_Map map;
+		for(const T_Key& key : keys)
+			map[key] = 1;
+
+		return best_of(RUNS, [&]
+		{
+			uint32_t found = 0;
+			const uint64_t begin = now();
+			for(uint64_t done = 0; done < OPERATIONS; done += lookups.size())
+				for(const T_Key& key : lookups)
+					found += map.find(key) != map.end() ? 1 : 0;
+			const uint64_t time = now() - begin;
+			keep(found);
+			return time;
+		});
+	}
+
+	// erases a key and inserts it back, at a constant size
+	template <class T_Map, class T_Key>
+	uint64_t churn(const vector<T_Key>& keys)
+	{
+		T_Map map;
+		for(const T_Key& key : keys)
+			map[key] = 1;
+
+		return best_of(RUNS, [&]
+		{
+			const uint64_t begin = now();
+			for(uint64_t done = 0; done < OPERATIONS; done += keys.size())
+				for(const T_Key& key : keys)
+				{
+					map.erase(key);
+					map[key] = 2;
+				}
+			const uint64_t time = now() - begin;
+			keep(map.size());
+			return time;
+		});
+	}
+
+	template <class T_Map, class T_Key>
+	uint64_t iterate(const vector<T_Key>& keys)
+	{
+		T_Map map;
+		for(const T_Key& key : keys)
+			map[key] = 1;
+
+		return best_of(RUNS, [&]
+		{
+			uint32_t sum = 0;
+			const uint64_t begin = now();
+			for(uint64_t done = 0; done < OPERATIONS; done += keys.size())
+				for(auto& entry : map)
+					sum += entry.second;
+			const uint64_t time = now() - begin;
+			keep(sum);
+			return time;
+		});
+	}
+
+	void compare(Report& report, const char* name, uint32_t size, uint64_t chained, uint64_t flat)
+	{
+		char chained_name[64];
+		char flat_name[64];
+		snprintf(chained_name, sizeof(chained_name), "%s_%u_chained", name, size);
+		snprintf(flat_name, sizeof(flat_name), "%s_%u_flat", name, size);
+		const uint64_t iterations = OPERATIONS;
+		report.add(chained_name, 1, iterations, chained);
+		report.add(flat_name, 1, iterations, flat, "speedup", double(chained) / double(flat));
+	}
+
+	template <class T_Key>
+	void compare_all(Report& report, const char* name, const vector<T_Key>& keys, const vector<T_Key>& missing)
+	{
+		using Chained = unordered_map<T_Key, uint32_t>;
+		using Flat = flat_map<T_Key, uint32_t>;
+
+		const uint32_t size = uint32_t(keys.size());
+		char label[64];
+
+		snprintf(label, sizeof(label), "%s_insert", name);
+		compare(report, label, size, insert<Chained>(keys), insert<Flat>(keys));
+		snprintf(label, sizeof(label), "%s_find_hit", name);
+		compare(report, label, size, find<Chained>(keys, keys), find<Flat>(keys, keys));
+		snprintf(label, sizeof(label), "%s_find_miss", name);
+		compare(report, label, size, find<Chained>(keys, missing), find<Flat>(keys, missing));
+		snprintf(label, sizeof(label), "%s_churn", name);
+		compare(report, label, size, churn<Chained>(keys), churn<Flat>(keys));
+		snprintf(label, sizeof(label), "%s_iterate", name);
+		compare(report, label, size, iterate<Chained>(keys), iterate<Flat>(keys));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const uint32_t max_size = Report::arg(argc, argv, "--size", 1 << 18);
+
+	Report report("hash", argc, argv);
+
+	// an iteration is one insertion, lookup, erase and insertion, or visited entry
+	for(uint32_t size = 64; size <= max_size; size *= 16)
+	{
+		compare_all(report, "u64", integer_keys(size, 1), integer_keys(size, 2));
+		compare_all(report, "string", string_keys(size, 1), string_keys(size, 2));
+	}
+
+	return 0;
+}
@@ -0,0 +1,226 @@
+#include <stl/vector.hpp>
+#include <jobs/JobSystem.h>
+#include <jobs/JobQueue.h>
+#include <jobs/JobLoop.hpp>
+#include <jobs/Job.h>
+#include <bench/Bench.h>
+
+#include <cmath>
+#include <atomic>
+#include <thread>
+
+// usage : mud_jobs_bench [--threads max_threads] [--out bench_jobs.json]
+
+using namespace mud;
+using namespace mud::bench;
+
+namespace
+{
+	constexpr uint32_t RUNS = 5;
+
+	// creates a parent with count empty children, runs them all and waits for the parent
+	void create_run_wait(Report& report, uint32_t threads)
+	{
+		constexpr uint32_t count = 10000;
+
+		JobSystem js(uint16_t(threads - 1), 1);
+		js.adopt();
+
+		const uint64_t time = best_of(RUNS, [&]
+		{
+			const uint64_t begin = now();
+			Job* parent = js.job();
+			for(uint32_t i = 0; i < count; ++i)
+				js.run(js.job(parent));
+			js.complete(parent);
+			return now() - begin;
+		});
+
+		report.add("create_run_wait", threads, count, time);
+		js.emancipate();
+	}
+
+	// one owner pushes and pops its queue while the other threads steal from it
+	void steal_throughput(Report& report, uint32_t threads)
+	{
+		constexpr uint32_t count = 1 << 20;
+		using Queue = StealQueue<uint32_t, 4096>;
+
+		const uint64_t time = best_of(RUNS, [&]
+		{
+			Queue queue;
+			std::atomic<uint32_t> consumed = { 0 };
+			std::atomic<uint64_t> stolen = { 0 };
+			std::atomic<bool> start = { false };
+
+			vector<std::thread> thieves;
+			for(uint32_t t = 1; t < threads; ++t)
+				thieves.push_back(std::thread([&]
+				{
+					while(!start.load(std::memory_order_acquire)) {}
+					uint64_t local = 0;
+					while(consumed.load(std::memory_order_relaxed) < count)
+						if(queue.steal())
+						{
+							consumed.fetch_add(1, std::memory_order_relaxed);
+							local++;
+						}
+					stolen += local;
+				}));
+
+			const uint64_t begin = now();
+			start.store(true, std::memory_order_release);
+			for(uint32_t pushed = 1; pushed <= count;)
+			{
+				if(queue.count() < int32_t(queue.size() / 2))
+					queue.push(pushed++);
+				// once its queue is half full, the owner pops like a worker executing its own jobs
+				else if(queue.pop())
+					consumed.fetch_add(1, std::memory_order_relaxed);
+			}
+			while(consumed.load(std::memory_order_relaxed) < count)
+				if(queue.pop())
+					consumed.fetch_add(1, std::memory_order_relaxed);
+			const uint64_t time = now() - begin;
+
+			for(std::thread& thief : thieves)
+				thief.join();
+			return time;
+		});
+
+		report.add("steal_queue_throughput", threads, count, time, "mitems_per_s", double(count) * 1000.0 / double(time));
+	}
+
+	// same work split over an increasing number of threads, the speedup is relative to the single thread run
+	void split_jobs_scaling(Report& report, uint32_t max_threads)
+	{
+		constexpr uint32_t count = 1 << 20;
+		vector<float> values(count);
+
+		uint64_t single = 0;
+		for(uint32_t threads = 1; threads <= max_threads; ++threads)
+		{
+			JobSystem js(uint16_t(threads - 1), 1);
+			js.adopt();
+
+			auto work = [&](JobSystem&, Job*, uint32_t start, uint32_t count)
+			{
+				for(uint32_t i = start; i < start + count; ++i)
+					values[i] = sqrtf(float(i)) * sinf(float(i));
+			};
+
+			const uint64_t time = best_of(RUNS, [&]
+			{
+				const uint64_t begin = now();
+				Job* job = split_jobs<1024>(js, nullptr, 0, count, work);
+				js.complete(job);
+				return now() - begin;
+			});
+
+			single = threads == 1 ? time : single;
+			report.add("split_jobs_scaling", threads, count, time, "speedup", double(single) / double(time));
+			js.emancipate();
+		}
+	}
+
+	uint64_t fib(uint32_t n)
+	{
+		return n < 2 ? n : fib(n - 1) + fib(n - 2);
+	}
+
+	// nested fork-join : each call forks its two halves as jobs and waits for them, down to a serial cutoff
+	uint64_t fib_jobs(JobSystem& js, uint32_t n, uint32_t& jobs)
+	{
+		if(n < 14)
+			return fib(n);
+
+		uint64_t left = 0, right = 0;
+		uint32_t left_jobs = 0, right_jobs = 0;
+		Job* parent = js.job();
+		Job* first = js.job(parent, [&](JobSystem& js, Job*) { left = fib_jobs(js, n - 1, left_jobs); });
+		Job* second = js.job(parent, [&](JobSystem& js, Job*) { right = fib_jobs(js, n - 2, right_jobs); });
+		js.run(first);
+		js.run(second);
+		js.complete(parent);
+		jobs += left_jobs + right_jobs + 3;
+		return left + right;
+	}
+
+	void fork_join_fib(Report& report, uint32_t threads)
+	{
+		constexpr uint32_t n = 27;
+
+		JobSystem js(uint16_t(threads - 1), 1);
+		js.adopt();
+
+		uint32_t jobs = 0;
+		const uint64_t time = best_of(RUNS, [&]
+		{
+			jobs = 0;
+			const uint64_t begin = now();
+			keep(fib_jobs(js, n, jobs));
+			return now() - begin;
+		});
+
+		report.add("fork_join_fib", threads, jobs, time);
+		js.emancipate();
+	}
+
+	// time from run() on the main thread to the start of the job on a worker, with workers spinning or parked
+	void empty_job_latency(Report& report, uint32_t threads, bool parked)
+	{
+		constexpr uint32_t count = 200;
+
+		JobSystem js(uint16_t(threads - 1), 1);
+		js.adopt();
+
+		uint64_t total = 0;
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			if(parked)
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+			std::atomic<uint64_t> started = { 0 };
+			Job* parent = js.job();
+			Job* job = js.job(parent, [&](JobSystem&, Job*) { started.store(now(), std::memory_order_release); });
+
+			const uint64_t begin = now();
+			js.run(job);
+			// don't wait() : the main thread would pick the jobs from its own queue
+			while(!started.load(std::memory_order_acquire)) {}
+			total += started.load(std::memory_order_relaxed) - begin;
+			js.complete(parent);
+		}
+
+		report.add(parked ? "empty_job_latency_parked" : "empty_job_latency_spinning", threads, count, total);
+		js.emancipate();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const uint32_t hardware = std::thread::hardware_concurrency();
+	const uint32_t max_threads = Report::arg(argc, argv, "--threads", hardware ? hardware : 1);
+
+	Report report("jobs", argc, argv);
+
+	create_run_wait(report, 1);
+	create_run_wait(report, max_threads);
+
+	for(uint32_t threads = 1; threads <= max_threads; threads *= 2)
+		steal_throughput(report, threads);
+
+	split_jobs_scaling(report, max_threads);
+
+	fork_join_fib(report, 1);
+	fork_join_fib(report, max_threads);
+
+	// latency needs a worker to pick the job up
+	if(max_threads > 1)
+	{
+		empty_job_latency(report, max_threads, false);
+		empty_job_latency(report, max_threads, true);
+	}
+
+	return 0;
+}
@@ -0,0 +1,199 @@
+#include <stl/vector.hpp>
+#include <type/Type.h>
+#include <pool/Pool.hpp>
+#include <pool/SparsePool.hpp>
+#include <pool/ConcurrentPool.hpp>
+#include <bench/Bench.h>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// usage : mud_pool_bench [--threads max_threads] [--out bench_pool.json]
+
+using namespace mud;
+using namespace mud::bench;
+
+namespace
+{
+	struct BenchObject
+	{
+		float m_values[16];
+	};
+}
+
+namespace mud
+{
+	template <> Type& type<BenchObject>() { static Type ty("BenchObject", sizeof(BenchObject)); return ty; }
+}
+
+namespace
+{
+	constexpr uint32_t RUNS = 5;
+	constexpr uint32_t ROUNDS = 2000;
+	constexpr uint32_t LIVE = 64;
+
+	// runs func(thread) on each thread once they are all started, returns the time until the last one is done
+	template <class T_Func>
+	uint64_t parallel(uint32_t threads, T_Func func)
+	{
+		std::atomic<bool> start = { false };
+		vector<std::thread> workers;
+		for(uint32_t t = 0; t < threads; ++t)
+			workers.push_back(std::thread([&, t]
+			{
+				while(!start.load(std::memory_order_acquire)) {}
+				func(t);
+			}));
+
+		const uint64_t begin = now();
+		start.store(true, std::memory_order_release);
+		for(std::thread& worker : workers)
+			worker.join();
+		return now() - begin;
+	}
+
+	// the current pools, with a lock around them : the only way to share them between threads
+	struct LockedPool
+	{
+		std::mutex m_mutex;
+		TPool<BenchObject> m_pool = TPool<BenchObject>(1024);
+
+		BenchObject* alloc() { std::lock_guard<std::mutex> lock(m_mutex); return m_pool.talloc(); }
+		void free(BenchObject* object) { std::lock_guard<std::mutex> lock(m_mutex); m_pool.tfree(*object); }
+	};
+
+	struct LockedSparsePool
+	{
+		std::mutex m_mutex;
+		SparsePool<BenchObject> m_pool;
+
+		uint32_t create()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			OwnedHandle<BenchObject> handle = m_pool.create();
+			// released from the owning handle, it's destroyed explicitly
+			const uint32_t index = handle.m_handle;
+			handle.m_handle = UINT32_MAX;
+			return index;
+		}
+
+		void destroy(uint32_t handle) { std::lock_guard<std::mutex> lock(m_mutex); m_pool.destroy(handle); }
+	};
+
+	struct LockFreePool
+	{
+		ConcurrentPool<BenchObject> m_pool = ConcurrentPool<BenchObject>(1024);
+
+		BenchObject* alloc() { return m_pool.talloc(); }
+		void free(BenchObject* object) { m_pool.tfree(*object); }
+	};
+
+	struct LockFreeSparsePool
+	{
+		ConcurrentSparsePool<BenchObject> m_pool = ConcurrentSparsePool<BenchObject>(1024);
+
+		uint32_t create() { return m_pool.create(); }
+		void destroy(uint32_t handle) { m_pool.destroy(handle); }
+	};
+
+	// each thread allocates a few objects, writes them, and frees them, over and over
+	template <class T_Pool>
+	uint64_t churn(uint32_t threads)
+	{
+		return best_of(RUNS, [&]
+		{
+			T_Pool pool;
+			return parallel(threads, [&](uint32_t)
+			{
+				BenchObject* objects[LIVE];
+				for(uint32_t round = 0; round < ROUNDS; ++round)
+				{
+					for(uint32_t i = 0; i < LIVE; ++i)
+					{
+						objects[i] = pool.alloc();
+						objects[i]->m_values[0] = float(i);
+					}
+					for(uint32_t i = 0; i < LIVE; ++i)
+						pool.free(objects[i]);
+				}
+			});
+		});
+	}
+
+	template <class T_Pool>
+	uint64_t sparse_churn(uint32_t threads)
+	{
+		return best_of(RUNS, [&]
+		{
+			T_Pool pool;
+			return parallel(threads, [&](uint32_t)
+			{
+				uint32_t handles[LIVE];
+				for(uint32_t round = 0; round < ROUNDS; ++round)
+				{
+					for(uint32_t i = 0; i < LIVE; ++i)
+						handles[i] = pool.create();
+					for(uint32_t i = 0; i < LIVE; ++i)
+						pool.destroy(handles[i]);
+				}
+			});
+		});
+	}
+
+	// objects allocated on one thread are freed on another, like scene objects built by workers and destroyed by the main thread
+	template <class T_Pool>
+	uint64_t handoff(uint32_t threads)
+	{
+		constexpr uint32_t count = ROUNDS * LIVE / 4;
+
+		return best_of(RUNS, [&]
+		{
+			T_Pool pool;
+			vector<vector<BenchObject*>> objects(threads);
+			for(vector<BenchObject*>& list : objects)
+				list.resize(count);
+
+			uint64_t time = parallel(threads, [&](uint32_t t)
+			{
+				for(uint32_t i = 0; i < count; ++i)
+					objects[t][i] = pool.alloc();
+			});
+			time += parallel(threads, [&](uint32_t t)
+			{
+				for(BenchObject* object : objects[(t + 1) % threads])
+					pool.free(object);
+			});
+			return time;
+		});
+	}
+
+	void compare(Report& report, const char* name, uint32_t threads, uint64_t iterations, uint64_t locked, uint64_t lockfree)
+	{
+		char locked_name[64];
+		char lockfree_name[64];
+		snprintf(locked_name, sizeof(locked_name), "%s_locked", name);
+		snprintf(lockfree_name, sizeof(lockfree_name), "%s_concurrent", name);
+		report.add(locked_name, threads, iterations, locked);
+		report.add(lockfree_name, threads, iterations, lockfree, "speedup", double(locked) / double(lockfree));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	const uint32_t hardware = std::thread::hardware_concurrency();
+	const uint32_t max_threads = Report::arg(argc, argv, "--threads", hardware ? hardware : 1);
+
+	Report report("pool", argc, argv);
+
+	// an iteration is one allocation and one free
+	for(uint32_t threads = 1; threads <= max_threads; threads *= 2)
+	{
+		const uint64_t iterations = uint64_t(threads) * ROUNDS * LIVE;
+		compare(report, "pool_churn", threads, iterations, churn<LockedPool>(threads), churn<LockFreePool>(threads));
+		compare(report, "sparse_pool_churn", threads, iterations, sparse_churn<LockedSparsePool>(threads), sparse_churn<LockFreeSparsePool>(threads));
+		compare(report, "pool_handoff", threads, uint64_t(threads) * ROUNDS * LIVE / 4, handoff<LockedPool>(threads), handoff<LockFreePool>(threads));
+	}
+
+	return 0;
+}
@@ -83,7 +83,7 @@ function uses_mud()
     end
     
     if _OPTIONS["profile"] then
-        defines { "TRACY_ENABLE" }
+        defines { "TRACY_ENABLE", "MUD_ALLOC_TAGS" }
     end
 end
 
@@ -276,7 +276,7 @@ mud.pool    = mud_module("mud", "pool",     MUD_SRC_DIR,    "pool",     nil,
 -- refl
 mud.refl    = mud_module("mud", "refl",     MUD_SRC_DIR,    "refl",     nil,        nil,            true,       { mud.infra, mud.type, mud.pool })
 -- ecs
-mud.ecs     = mud_module("mud", "ecs",      MUD_SRC_DIR,    "ecs",      nil,        uses_mud,       true,       { mud.infra, mud.pool, mud.type })
+mud.ecs     = mud_module("mud", "ecs",      MUD_SRC_DIR,    "ecs",      nil,        uses_mud,       true,       { mud.infra, mud.jobs, mud.pool, mud.type })
 -- srlz
 mud.srlz    = mud_module("mud", "srlz",     MUD_SRC_DIR,    "srlz",     mud_srlz,   nil,            true,       { json11, mud.infra, mud.type, mud.refl })
 -- math
@@ -406,6 +406,37 @@ function mud_binary(name, modules, deps)
     mud_binary_config()
 end
 
+function mud_bench(name, deps)
+    local m = mud_module(nil, name .. "_bench", MUD_DIR, path.join("bench", name), nil, nil, false, deps, true)
+    mud_binary("mud_" .. name .. "_bench", { m }, deps)
+    return m
+end
+
+if _OPTIONS["bench"] then
+    group "bench"
+    mud.bench = {}
+    mud.bench.jobs = mud_bench("jobs", { mud.infra, mud.jobs })
+    mud.bench.pool = mud_bench("pool", { mud.infra, mud.type, mud.pool })
+    mud.bench.hash = mud_bench("hash", { mud.infra })
+    mud.bench.containers = mud_bench("containers", { mud.infra })
+    group "lib"
+end
+
+function mud_test(name, deps)
+    local m = mud_module(nil, name .. "_test", MUD_DIR, path.join("test", name), nil, nil, false, deps, true)
+    mud_binary("mud_" .. name .. "_test", { m }, deps)
+    return m
+end
+
+if _OPTIONS["tests"] then
+    group "tests"
+    mud.tests = {}
+    mud.tests.stl = mud_test("stl", { mud.infra })
+    mud.tests.jobs = mud_test("jobs", { mud.infra, mud.jobs })
+    mud.tests.ecs = mud_test("ecs", { mud.infra, mud.jobs, mud.type, mud.pool, mud.ecs })
+    group "lib"
+end
+
 function mud_js(name, modules)
     local lib = mud_lib(name, {}, "ConsoleApp", modules)
     mud_glue_js(table.inverse(lib.deps))
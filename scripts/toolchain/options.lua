@@ -61,6 +61,16 @@ newoption {
     description = "Build tools",
 }
 
+newoption {
+    trigger = "bench",
+    description = "Build benchmarks",
+}
+
+newoption {
+    trigger = "tests",
+    description = "Build tests",
+}
+
 --newoption {
 --    trigger = "renderer",
 --    --value = "toolset",
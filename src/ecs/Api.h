@@ -1,7 +1,10 @@
 #include <ecs/Entity.h>
 #include <ecs/ECS.h>
 //#include <ecs/ECS.hpp>
+#include <ecs/Commands.h>
 #include <ecs/Complex.h>
+#include <ecs/System.h>
+#include <ecs/Snapshot.h>
 #include <ecs/Forward.h>
 #include <ecs/Types.h>
 
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stl/new.h>
+#include <stl/move.h>
+#include <stl/type_traits.h>
+#include <stl/bitset.h>
+#include <infra/Generic.h>
+#include <ecs/Forward.h>
+#include <ecs/Buffer.h>
+#include <ecs/Entity.h>
+
+#include <stdint.h>
+
+#ifndef MUD_ECS_MAX_COMPONENTS
+#define MUD_ECS_MAX_COMPONENTS 256
+#endif
+
+namespace mud
+{
+	// set of component types, prototype of a stream or signature of a query
+	using ComponentMask = bitset<uint64_t, (MUD_ECS_MAX_COMPONENTS + 63) / 64>;
+
+	inline ComponentMask component_flag(uint32_t index)
+	{
+		ComponentMask mask;
+		mask.set(index);
+		return mask;
+	}
+
+	template <class... Types>
+	inline ComponentMask component_mask()
+	{
+		ComponentMask mask;
+		swallow{ (mask.set(TypedBuffer<Types>::index()), 0)... };
+		return mask;
+	}
+
+	inline bool contains(const ComponentMask& mask, const ComponentMask& components) { return (mask & components) == components; }
+
+	// type-erased description of a component array inside a chunk
+	// trivially copyable components are constructed and relocated with a plain memcpy, the others go through the function pointers
+	struct ComponentColumn
+	{
+		uint32_t m_index = 0;
+		uint32_t m_size = 0;
+		uint32_t m_align = 0;
+		uint32_t m_offset = 0;
+		uint32_t m_default = 0;
+		bool m_trivial = false;
+
+#ifdef MUD_ECS_TYPED
+		Type* m_type = nullptr;
+#endif
+		void(*m_construct)(void* at) = nullptr;
+		void(*m_relocate)(void* at, void* from) = nullptr;
+		void(*m_destroy)(void* at) = nullptr;
+	};
+
+	template <class T>
+	inline ComponentColumn component_column()
+	{
+		ComponentColumn column;
+		column.m_index = TypedBuffer<T>::index();
+		column.m_size = sizeof(T);
+		column.m_align = alignof(T);
+		column.m_trivial = is_trivially_copyable<T>;
+#ifdef MUD_ECS_TYPED
+		column.m_type = &type<T>();
+#endif
+		column.m_construct = [](void* at) { new (stl::placeholder(), at) T(); };
+		column.m_relocate = [](void* at, void* from) { new (stl::placeholder(), at) T(move(*static_cast<T*>(from))); static_cast<T*>(from)->~T(); };
+		column.m_destroy = [](void* at) { static_cast<T*>(at)->~T(); };
+		return column;
+	}
+
+	// shared descriptor of a component type, for code that refers to components without a stream
+	template <class T>
+	inline const ComponentColumn& component_desc()
+	{
+		static ComponentColumn column = component_column<T>();
+		return column;
+	}
+}
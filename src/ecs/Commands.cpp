@@ -0,0 +1,154 @@
+//  Copyright (c) 2019 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <infra/Cpp20.h>
+
+#ifdef MUD_MODULES
+module mud.ecs;
+#else
+#include <stl/vector.hpp>
+#include <infra/AlignedAlloc.h>
+#include <infra/Sort.h>
+#include <ecs/ECS.h>
+#include <ecs/ECS.hpp>
+#include <ecs/Commands.h>
+#endif
+
+namespace mud
+{
+	CommandBuffer::CommandBuffer(ECS& ecs)
+		: m_ecs(ecs)
+	{}
+
+	CommandBuffer::~CommandBuffer()
+	{
+		this->clear();
+	}
+
+	void* CommandBuffer::alloc(uint32_t size, uint32_t align)
+	{
+		uint32_t offset = (m_offset + align - 1) & ~(align - 1);
+		if(m_blocks.empty() || offset + size > BLOCK_SIZE)
+		{
+			m_blocks.push_back(static_cast<char*>(aligned_alloc(max(size, BLOCK_SIZE), 64)));
+			offset = 0;
+		}
+		m_offset = offset + size;
+		return m_blocks.back() + offset;
+	}
+
+	void CommandBuffer::clear()
+	{
+		// values of commands that weren't applied are still alive
+		for(EntityCommand& command : m_commands)
+			if(command.m_value)
+				command.m_component->m_destroy(command.m_value);
+
+		for(char* block : m_blocks)
+			aligned_free(block);
+
+		m_commands.clear();
+		m_blocks.clear();
+		m_offset = BLOCK_SIZE;
+	}
+
+	CommandBuffers::CommandBuffers(ECS& ecs, uint32_t num_threads)
+		: m_ecs(ecs)
+	{
+		for(uint32_t i = 0; i < num_threads; ++i)
+			m_buffers.push_back(construct<CommandBuffer>(ecs));
+	}
+
+	CommandBuffers::~CommandBuffers()
+	{}
+
+	void CommandBuffers::apply()
+	{
+		alloc_scope tag(alloc_tag::ecs);
+
+		struct Entry { uint32_t m_key; uint32_t m_buffer; uint32_t m_index; };
+
+		vector<Entry> order;
+		for(uint32_t b = 0; b < uint32_t(m_buffers.size()); ++b)
+			for(uint32_t i = 0; i < uint32_t(m_buffers[b]->m_commands.size()); ++i)
+				order.push_back({ m_buffers[b]->m_commands[i].m_key, b, i });
+
+		auto greater = [](const Entry& a, const Entry& b)
+		{
+			if(a.m_key != b.m_key) return a.m_key > b.m_key;
+			if(a.m_buffer != b.m_buffer) return a.m_buffer > b.m_buffer;
+			return a.m_index > b.m_index;
+		};
+		quicksort<Entry>(order, greater);
+
+		auto command = [&](size_t i) -> EntityCommand& { return m_buffers[order[i].m_buffer]->m_commands[order[i].m_index]; };
+
+		// a run of commands adding or removing the same component is migrated as one batch
+		auto run_end = [&](size_t begin)
+		{
+			const EntityCommand& first = command(begin);
+			size_t end = begin + 1;
+			if(first.m_type == EntityCommand::Add || first.m_type == EntityCommand::Remove)
+				while(end < order.size() && command(end).m_type == first.m_type && command(end).m_component == first.m_component)
+					++end;
+			return end;
+		};
+
+		ECS& ecs = m_ecs;
+		vector<uint32_t> handles;
+		for(size_t begin = 0, end = 0; begin < order.size(); begin = end)
+		{
+			end = run_end(begin);
+			EntityCommand& first = command(begin);
+
+			// commands on an entity destroyed earlier in the same batch are dropped
+			if(first.m_type == EntityCommand::Add || first.m_type == EntityCommand::Remove)
+			{
+				handles.clear();
+				for(size_t i = begin; i < end; ++i)
+					if(ecs.alive(command(i).m_handle))
+						handles.push_back(command(i).m_handle);
+
+				const bool add = first.m_type == EntityCommand::Add;
+				const ComponentMask flag = component_flag(first.m_component->m_index);
+				ecs.migrate(handles, add ? flag : ComponentMask(), add ? ComponentMask() : flag, first.m_component);
+
+				if(add)
+					for(size_t i = begin; i < end; ++i)
+						if(ecs.alive(command(i).m_handle))
+						{
+							ecs.write(command(i).m_handle, *first.m_component, command(i).m_value);
+							command(i).m_value = nullptr;
+						}
+				continue;
+			}
+
+			const uint32_t handle = first.m_handle;
+			if(first.m_type != EntityCommand::Create && !ecs.alive(handle))
+				continue;
+
+			switch(first.m_type)
+			{
+			case EntityCommand::Create:
+				ecs.insert(handle, first.m_stream(ecs));
+				break;
+			case EntityCommand::Destroy:
+				ecs.destroy(handle);
+				break;
+			case EntityCommand::Set:
+				if(ecs.prototype(handle).test(first.m_component->m_index))
+				{
+					ecs.write(handle, *first.m_component, first.m_value);
+					first.m_value = nullptr;
+				}
+				break;
+			default:
+				break;
+			}
+		}
+
+		for(unique<CommandBuffer>& buffer : m_buffers)
+			buffer->clear();
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <stl/vector.h>
+#include <stl/memory.h>
+#include <ecs/Forward.h>
+#include <ecs/Chunk.h>
+
+#include <stdint.h>
+
+namespace mud
+{
+	struct EntityCommand
+	{
+		enum Type : uint8_t { Create, Destroy, Add, Remove, Set };
+
+		Type m_type;
+		uint32_t m_key;
+		uint32_t m_handle;
+		uint16_t(*m_stream)(ECS& ecs) = nullptr;
+		const ComponentColumn* m_component = nullptr;
+		void* m_value = nullptr;
+	};
+
+	// structural changes recorded by a single thread, while the ECS can't be modified, for instance from for_components jobs
+	// component values are stored in blocks that never move, until the commands are applied or cleared
+	class MUD_ECS_EXPORT CommandBuffer
+	{
+	public:
+		static constexpr uint32_t BLOCK_SIZE = 4 * 1024;
+
+		CommandBuffer(ECS& ecs);
+		~CommandBuffer();
+
+		CommandBuffer(const CommandBuffer& other) = delete;
+		CommandBuffer& operator=(const CommandBuffer& other) = delete;
+
+		// commands are applied in order of their key, then in the order they were recorded
+		// jobs recording concurrently should use distinct keys, like the index of the chunk or entity they process
+		void key(uint32_t key) { m_key = key; }
+
+		// the handle is reserved right away, so that it can be referred to by other commands or stored in components
+		template <class... Types>
+		uint32_t create();
+
+		// creates the entity with a handle from ECS::reserve(), to give handles that don't depend on scheduling
+		template <class... Types>
+		void create(uint32_t handle);
+
+		void destroy(uint32_t handle);
+
+		template <class T>
+		void add(uint32_t handle, T component = T());
+
+		template <class T>
+		void remove(uint32_t handle);
+
+		template <class T>
+		void set(uint32_t handle, T component);
+
+		void clear();
+
+		ECS& m_ecs;
+		uint32_t m_key = 0;
+
+		vector<EntityCommand> m_commands;
+
+	private:
+		template <class T>
+		void* value(T&& component);
+
+		void* alloc(uint32_t size, uint32_t align);
+
+		vector<char*> m_blocks;
+		uint32_t m_offset = BLOCK_SIZE;
+	};
+
+	// one command buffer per thread index, merged and applied at a sync point from a single thread
+	// the order only depends on the keys and the recording order, not on which thread recorded what
+	class MUD_ECS_EXPORT CommandBuffers
+	{
+	public:
+		CommandBuffers(ECS& ecs, uint32_t num_threads);
+		~CommandBuffers();
+
+		CommandBuffer& buffer(uint32_t thread) { return *m_buffers[thread]; }
+
+		void apply();
+
+		ECS& m_ecs;
+		vector<unique<CommandBuffer>> m_buffers;
+	};
+}
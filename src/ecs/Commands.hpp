@@ -0,0 +1,65 @@
+#pragma once
+
+#include <stl/move.h>
+#include <stl/new.h>
+#include <ecs/Commands.h>
+#include <ecs/ECS.hpp>
+
+namespace mud
+{
+	template <class T>
+	inline void* CommandBuffer::value(T&& component)
+	{
+		using U = remove_cv<remove_reference<T>>;
+		void* value = this->alloc(sizeof(U), alignof(U));
+		new (stl::placeholder(), value) U(static_cast<T&&>(component));
+		return value;
+	}
+
+	template <class... Types>
+	inline uint32_t CommandBuffer::create()
+	{
+		const uint32_t handle = m_ecs.reserve();
+		this->create<Types...>(handle);
+		return handle;
+	}
+
+	template <class... Types>
+	inline void CommandBuffer::create(uint32_t handle)
+	{
+		EntityCommand command = { EntityCommand::Create, m_key, handle };
+		command.m_stream = [](ECS& ecs) { return ecs.stream_index<Types...>(); };
+		m_commands.push_back(command);
+	}
+
+	inline void CommandBuffer::destroy(uint32_t handle)
+	{
+		m_commands.push_back({ EntityCommand::Destroy, m_key, handle });
+	}
+
+	template <class T>
+	inline void CommandBuffer::add(uint32_t handle, T component)
+	{
+		EntityCommand command = { EntityCommand::Add, m_key, handle };
+		command.m_component = &component_desc<T>();
+		command.m_value = this->value(move(component));
+		m_commands.push_back(command);
+	}
+
+	template <class T>
+	inline void CommandBuffer::remove(uint32_t handle)
+	{
+		EntityCommand command = { EntityCommand::Remove, m_key, handle };
+		command.m_component = &component_desc<T>();
+		m_commands.push_back(command);
+	}
+
+	template <class T>
+	inline void CommandBuffer::set(uint32_t handle, T component)
+	{
+		EntityCommand command = { EntityCommand::Set, m_key, handle };
+		command.m_component = &component_desc<T>();
+		command.m_value = this->value(move(component));
+		m_commands.push_back(command);
+	}
+}
@@ -0,0 +1,436 @@
+//  Copyright (c) 2019 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <infra/Cpp20.h>
+
+#ifdef MUD_MODULES
+module mud.ecs;
+#else
+#include <stl/vector.hpp>
+#include <infra/AlignedAlloc.h>
+#include <infra/Sort.h>
+#include <ecs/ECS.h>
+#include <ecs/ECS.hpp>
+#endif
+
+#include <cassert>
+#include <cstring>
+
+namespace mud
+{
+	static constexpr uint32_t c_chunk_align = 64;
+
+	inline uint32_t align_up(uint32_t offset, uint32_t align)
+	{
+		return (offset + align - 1) & ~(align - 1);
+	}
+
+	EntityStream::EntityStream() {}
+	EntityStream::EntityStream(cstring name)
+		: m_name(name)
+	{}
+
+	EntityStream::~EntityStream()
+	{
+		this->clear();
+		if(m_defaults)
+		{
+			for(const ComponentColumn& column : m_columns)
+				column.m_destroy(m_defaults + column.m_default);
+			aligned_free(m_defaults);
+		}
+	}
+
+	EntityStream::EntityStream(EntityStream&& other)
+	{
+		*this = move(other);
+	}
+
+	EntityStream& EntityStream::operator=(EntityStream&& other)
+	{
+		using mud::swap;
+		swap(m_name, other.m_name);
+		swap(m_prototype, other.m_prototype);
+		swap(m_columns, other.m_columns);
+		swap(m_column_map, other.m_column_map);
+		swap(m_capacity, other.m_capacity);
+		swap(m_chunk_size, other.m_chunk_size);
+		swap(m_count, other.m_count);
+		swap(m_entities, other.m_entities);
+		swap(m_chunks, other.m_chunks);
+		swap(m_versions, other.m_versions);
+		swap(m_rows_version, other.m_rows_version);
+		swap(m_spare, other.m_spare);
+		swap(m_defaults, other.m_defaults);
+		return *this;
+	}
+
+	void EntityStream::layout()
+	{
+		// the handles array comes first, then each component array aligned on its type
+		auto chunk_size = [&](uint32_t capacity)
+		{
+			uint32_t offset = capacity * sizeof(uint32_t);
+			for(ComponentColumn& column : m_columns)
+			{
+				assert(column.m_align <= c_chunk_align);
+				offset = align_up(offset, column.m_align);
+				column.m_offset = offset;
+				offset += capacity * column.m_size;
+			}
+			return offset;
+		};
+
+		// the default row is laid out as a chunk of capacity one
+		const uint32_t row_size = chunk_size(1);
+		for(ComponentColumn& column : m_columns)
+			column.m_default = column.m_offset;
+
+		uint32_t row = sizeof(uint32_t);
+		for(const ComponentColumn& column : m_columns)
+			row += column.m_size;
+
+		m_capacity = max(CHUNK_SIZE / row, 1U);
+		while(m_capacity > 1 && chunk_size(m_capacity) > CHUNK_SIZE)
+			m_capacity--;
+		m_chunk_size = max(chunk_size(m_capacity), CHUNK_SIZE);
+
+		static_assert(MUD_ECS_MAX_COMPONENTS < UINT16_MAX, "column map entries are 16 bit, with UINT16_MAX for absent components");
+		m_column_map.resize(MUD_ECS_MAX_COMPONENTS, uint16_t(UINT16_MAX));
+		for(uint32_t i = 0; i < uint32_t(m_columns.size()); ++i)
+			m_column_map[m_columns[i].m_index] = uint16_t(i);
+
+		m_defaults = static_cast<char*>(aligned_alloc(row_size, c_chunk_align));
+		for(const ComponentColumn& column : m_columns)
+			column.m_construct(m_defaults + column.m_default);
+	}
+
+	char* EntityStream::alloc_chunk()
+	{
+		char* chunk = m_spare;
+		m_spare = nullptr;
+		return chunk ? chunk : static_cast<char*>(aligned_alloc(m_chunk_size, c_chunk_align));
+	}
+
+	void EntityStream::free_chunk(char* chunk)
+	{
+		// keep one chunk around, so that a stream going back and forth over a chunk boundary doesn't hit the allocator
+		if(m_spare)
+			aligned_free(m_spare);
+		m_spare = chunk;
+	}
+
+	void* EntityStream::at(uint32_t column, uint32_t index)
+	{
+		const ComponentColumn& c = m_columns[column];
+		return m_chunks[index / m_capacity] + c.m_offset + (index % m_capacity) * c.m_size;
+	}
+
+#ifdef MUD_ECS_TYPED
+	Ref EntityStream::get(uint32_t column, uint32_t index)
+	{
+		return Ref(this->at(column, index), *m_columns[column].m_type);
+	}
+#endif
+
+	void EntityStream::clear()
+	{
+		for(uint32_t c = 0; c < uint32_t(m_columns.size()); ++c)
+			if(!m_columns[c].m_trivial)
+				for(uint32_t i = 0; i < m_count; ++i)
+					m_columns[c].m_destroy(this->at(c, i));
+
+		for(char* chunk : m_chunks)
+			aligned_free(chunk);
+		if(m_spare)
+			aligned_free(m_spare);
+
+		m_chunks.clear();
+		m_versions.clear();
+		m_spare = nullptr;
+		m_count = 0;
+	}
+
+	bool EntityStream::changed(uint32_t chunk, const ComponentMask& components, uint32_t since) const
+	{
+		const uint32_t* versions = m_versions.data() + chunk * m_columns.size();
+		for(uint32_t c = 0; c < uint32_t(m_columns.size()); ++c)
+			if(components.test(m_columns[c].m_index) && versions[c] > since)
+				return true;
+		return false;
+	}
+
+	void EntityStream::construct(uint32_t column, uint32_t index)
+	{
+		const ComponentColumn& c = m_columns[column];
+		void* at = this->at(column, index);
+		if(c.m_trivial)
+			memcpy(at, m_defaults + c.m_default, c.m_size);
+		else
+			c.m_construct(at);
+	}
+
+	uint32_t EntityStream::push(uint32_t handle, uint32_t version)
+	{
+		const uint32_t index = m_count++;
+		if(index == uint32_t(m_chunks.size()) * m_capacity)
+		{
+			m_chunks.push_back(this->alloc_chunk());
+			m_versions.resize(m_chunks.size() * m_columns.size());
+		}
+
+		for(uint32_t c = 0; c < uint32_t(m_columns.size()); ++c)
+			m_versions[(index / m_capacity) * m_columns.size() + c] = version;
+		m_rows_version = version;
+
+		this->handles(index / m_capacity)[index % m_capacity] = handle;
+		(*m_entities)[handle].m_row = index;
+		return index;
+	}
+
+	void EntityStream::add(uint32_t handle, uint32_t version)
+	{
+		const uint32_t index = this->push(handle, version);
+		for(uint32_t c = 0; c < uint32_t(m_columns.size()); ++c)
+			this->construct(c, index);
+	}
+
+	void EntityStream::remove(uint32_t handle, uint32_t version, const ComponentMask& moved)
+	{
+		this->erase(this->index(handle), version, moved);
+	}
+
+	void EntityStream::erase(uint32_t index, uint32_t version, const ComponentMask& moved)
+	{
+		const uint32_t last = --m_count;
+		m_rows_version = version;
+
+		char* chunk = m_chunks[index / m_capacity];
+		char* last_chunk = m_chunks[last / m_capacity];
+		const uint32_t slot = index % m_capacity;
+		const uint32_t last_slot = last % m_capacity;
+
+		// the moved components were already relocated out of the slot, there is nothing left to destroy
+		for(const ComponentColumn& column : m_columns)
+		{
+			void* at = chunk + column.m_offset + slot * column.m_size;
+			void* from = last_chunk + column.m_offset + last_slot * column.m_size;
+			const bool dead = moved.test(column.m_index);
+			if(column.m_trivial)
+			{
+				if(index != last)
+					memcpy(at, from, column.m_size);
+			}
+			else
+			{
+				if(!dead)
+					column.m_destroy(at);
+				if(index != last)
+					column.m_relocate(at, from);
+			}
+		}
+
+		if(index != last)
+		{
+			const uint32_t swapped = reinterpret_cast<uint32_t*>(last_chunk)[last_slot];
+			reinterpret_cast<uint32_t*>(chunk)[slot] = swapped;
+			(*m_entities)[swapped].m_row = index;
+
+			for(uint32_t c = 0; c < uint32_t(m_columns.size()); ++c)
+				m_versions[(index / m_capacity) * m_columns.size() + c] = version;
+		}
+
+		if(last_slot == 0)
+		{
+			this->free_chunk(m_chunks.back());
+			m_chunks.pop_back();
+			m_versions.resize(m_chunks.size() * m_columns.size());
+		}
+	}
+
+	uint16_t ECS::add_stream(EntityStream&& stream)
+	{
+		const ComponentMask prototype = stream.m_prototype;
+		const uint16_t index = uint16_t(m_streams.size());
+		m_stream_map[prototype] = index;
+		m_streams.push_back(move(stream));
+		m_streams.back().m_entities = &m_entities;
+
+		m_components.resize(MUD_ECS_MAX_COMPONENTS);
+		for(const ComponentColumn& column : m_streams.back().m_columns)
+			m_components[column.m_index] = column;
+
+		for(unique<Query>& query : m_queries)
+			if(query->m_signature.match(prototype))
+				query->m_streams.push_back(index);
+		return index;
+	}
+
+	void ECS::insert(uint32_t handle, uint16_t stream)
+	{
+		if(handle >= m_entities.size())
+			m_entities.resize(handle + 1);
+		m_entities[handle].m_stream = stream;
+		m_streams[stream].add(handle, m_version);
+	}
+
+	uint16_t ECS::stream_index(const ComponentMask& prototype, uint16_t base, const ComponentColumn* component)
+	{
+		if(m_stream_map.find(prototype) != m_stream_map.end())
+			return m_stream_map[prototype];
+
+		// the new stream has the components of the base stream that are in the prototype, plus the added ones
+		const EntityStream& source = m_streams[base];
+		EntityStream stream = { source.m_name };
+		stream.m_prototype = prototype;
+		for(const ComponentColumn& column : source.m_columns)
+			if(prototype.test(column.m_index))
+				stream.m_columns.push_back(column);
+		prototype.for_each([&](size_t index)
+		{
+			if(source.m_prototype.test(index))
+				return;
+			if(component && component->m_index == index)
+				stream.m_columns.push_back(*component);
+			else
+				stream.m_columns.push_back(m_components[index]);
+		});
+		stream.layout();
+		return this->add_stream(move(stream));
+	}
+
+	uint16_t ECS::stream_index(const ComponentMask& prototype)
+	{
+		if(m_stream_map.find(prototype) != m_stream_map.end())
+			return m_stream_map[prototype];
+
+		EntityStream stream = { "Entity" };
+		stream.m_prototype = prototype;
+		bool known = true;
+		prototype.for_each([&](size_t index)
+		{
+			known &= index < m_components.size() && m_components[index].m_size > 0;
+			if(known)
+				stream.m_columns.push_back(m_components[index]);
+		});
+		if(!known)
+			return UINT16_MAX;
+		stream.layout();
+		return this->add_stream(move(stream));
+	}
+
+	void ECS::migrate(uint32_t handle, const ComponentMask& prototype, const ComponentColumn* component)
+	{
+		const ComponentMask current = this->prototype(handle);
+		this->migrate({ &handle, 1 }, prototype & ~current, current & ~prototype, component);
+	}
+
+	void ECS::migrate(span<uint32_t> handles, const ComponentMask& add, const ComponentMask& remove, const ComponentColumn* component)
+	{
+		// the columns of the added components come from m_components, except the one passed, which can be new to the ecs
+		m_components.resize(MUD_ECS_MAX_COMPONENTS);
+		uint32_t unknown = 0;
+		add.for_each([&](size_t index) { unknown += m_components[index].m_size == 0 && !(component && component->m_index == index); });
+		assert(unknown == 0 && "migrate can only add components known to the ecs, or the one passed");
+
+		struct Row { uint16_t m_stream; uint32_t m_row; uint32_t m_handle; };
+
+		vector<Row> rows;
+		rows.reserve(handles.size());
+		for(uint32_t handle : handles)
+		{
+			const EntityData& entity = m_entities[handle];
+			const ComponentMask& prototype = m_streams[entity.m_stream].m_prototype;
+			if(((prototype | add) & ~remove) != prototype)
+				rows.push_back({ entity.m_stream, entity.m_row, handle });
+		}
+
+		// rows are grouped by source stream in ascending order, so that consecutive rows are moved as one block
+		auto greater = [](const Row& a, const Row& b) { return a.m_stream != b.m_stream ? a.m_stream > b.m_stream : a.m_row > b.m_row; };
+		quicksort<Row>(rows, greater);
+
+		vector<Row> group;
+		for(size_t begin = 0, end = 0; begin < rows.size(); begin = end)
+		{
+			group.clear();
+			for(end = begin; end < rows.size() && rows[end].m_stream == rows[begin].m_stream; ++end)
+				if(group.empty() || group.back().m_row != rows[end].m_row)
+					group.push_back(rows[end]);
+
+			const uint16_t source = rows[begin].m_stream;
+			const ComponentMask prototype = (m_streams[source].m_prototype | add) & ~remove;
+			const uint16_t dest = this->stream_index(prototype, source, component);
+
+			EntityStream& from = m_streams[source];
+			EntityStream& to = m_streams[dest];
+
+			// the column mapping is resolved once for the whole group
+			vector<uint16_t> shared(to.m_columns.size());
+			ComponentMask moved;
+			for(uint32_t c = 0; c < uint32_t(to.m_columns.size()); ++c)
+			{
+				shared[c] = from.m_column_map[to.m_columns[c].m_index];
+				if(shared[c] != UINT16_MAX)
+					moved.set(to.m_columns[c].m_index);
+			}
+
+			const uint32_t first = to.size();
+			for(const Row& row : group)
+				to.push(row.m_handle, m_version);
+
+			// a run is a range of consecutive source rows that doesn't cross a chunk boundary on either side
+			const uint32_t count = uint32_t(group.size());
+			for(uint32_t i = 0, run = 1; i < count; i += run)
+			{
+				const uint32_t row = group[i].m_row;
+				for(run = 1; i + run < count && group[i + run].m_row == row + run
+							 && (row + run) % from.m_capacity != 0 && (first + i + run) % to.m_capacity != 0; ++run) {}
+
+				for(uint32_t c = 0; c < uint32_t(to.m_columns.size()); ++c)
+				{
+					const ComponentColumn& column = to.m_columns[c];
+					if(shared[c] == UINT16_MAX)
+					{
+						for(uint32_t r = 0; r < run; ++r)
+							to.construct(c, first + i + r);
+						continue;
+					}
+
+					char* at = static_cast<char*>(to.at(c, first + i));
+					char* value = static_cast<char*>(from.at(shared[c], row));
+					if(column.m_trivial)
+						memcpy(at, value, run * column.m_size);
+					else
+						for(uint32_t r = 0; r < run; ++r)
+							column.m_relocate(at + r * column.m_size, value + r * column.m_size);
+				}
+			}
+
+			// erasing from the last row down, the row swapped in is never one still to be erased
+			for(uint32_t i = count; i > 0; --i)
+			{
+				from.erase(group[i - 1].m_row, m_version, moved);
+				m_entities[group[i - 1].m_handle].m_stream = dest;
+			}
+		}
+	}
+
+	void ECS::write(uint32_t handle, const ComponentColumn& component, void* value)
+	{
+		EntityStream& stream = m_streams[m_entities[handle].m_stream];
+		const uint16_t column = stream.m_column_map[component.m_index];
+		const uint32_t index = stream.index(handle);
+
+		stream.touch(index / stream.m_capacity, column, m_version);
+
+		void* at = stream.at(column, index);
+		if(component.m_trivial)
+			memcpy(at, value, component.m_size);
+		else
+		{
+			component.m_destroy(at);
+			component.m_relocate(at, value);
+		}
+	}
+}
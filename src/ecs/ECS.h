@@ -2,27 +2,72 @@
 #pragma once
 
 #include <stdint.h>
+#include <atomic>
 #include <stl/memory.h>
+#include <stl/math.h>
 #include <stl/map.h>
+#include <stl/span.h>
 #include <pool/SparsePool.h>
 #include <type/Type.h>
 #include <type/Ref.h>
 #include <ecs/Forward.h>
 #include <ecs/Entity.h>
 #include <ecs/Buffer.h>
+#include <ecs/Chunk.h>
 
 namespace mud
 {
+	// location of an entity : the stream of its prototype, and its row in that stream
 	struct EntityData
 	{
-		uint64_t m_prototype = 0;
-		uint16_t m_stream = 0;
+		uint32_t m_row = 0;
+		uint16_t m_stream = UINT16_MAX;
 
-		bool operator<(EntityData& other) const { return m_prototype < other.m_prototype; }
+		bool operator<(EntityData& other) const { return m_stream < other.m_stream; }
 	};
 	
 	using Typemap = vector<uint32_t>;
 
+	// component signature of a query : matching streams have all the components in m_with and none of those in m_without
+	// when iterated with a version, only the chunks where one of the m_changed components was written since that version are visited
+	struct QuerySignature
+	{
+		ComponentMask m_with;
+		ComponentMask m_without;
+		ComponentMask m_changed;
+
+		template <class... Types>
+		QuerySignature without() const;
+
+		template <class... Types>
+		QuerySignature changed() const;
+
+		bool match(const ComponentMask& prototype) const { return contains(prototype, m_with) && (prototype & m_without).none(); }
+		bool operator==(const QuerySignature& other) const { return m_with == other.m_with && m_without == other.m_without && m_changed == other.m_changed; }
+
+		// components whose writes make a chunk visited by an iteration since a version
+		const ComponentMask& tracked() const { return m_changed.any() ? m_changed : m_with; }
+	};
+
+	inline size_t hash(const QuerySignature& signature)
+	{
+		return (stl::hash(signature.m_with) * 31 + stl::hash(signature.m_without)) * 31 + stl::hash(signature.m_changed);
+	}
+
+	template <class... Types>
+	QuerySignature with();
+
+	// persistent query, registered once per signature : the streams it matches are kept up to date as streams are added
+	// queries are registered and streams added from a single thread, iterating a registered query is read-only
+	class Query
+	{
+	public:
+		Query(const QuerySignature& signature) : m_signature(signature) {}
+
+		QuerySignature m_signature;
+		vector<uint16_t> m_streams;
+	};
+
 	template <bool Dense>
 	class BufferArray
 	{
@@ -74,17 +119,105 @@ namespace mud
 		vector<Buffer*> m_buffer_map;
 	};
 
-	class EntityStream : public BufferArray<false>
+	// archetype storage : all entities of a prototype are packed in fixed size chunks, each chunk holding one array per component (SoA)
+	// rows are contiguous, row i is in chunk i / capacity at slot i % capacity, and removing a row moves the last one into its slot
+	// the row of each entity is kept in the entity table of the ECS, so a stream holds no memory proportional to the total entity count
+	class MUD_ECS_EXPORT EntityStream
 	{
 	public:
+		static constexpr uint32_t CHUNK_SIZE = 16 * 1024;
+
 		EntityStream();
-		EntityStream(cstring name, Typemap& typemap, uint32_t size = 0);
+		EntityStream(cstring name);
+		~EntityStream();
+
+		EntityStream(EntityStream&& other);
+		EntityStream& operator=(EntityStream&& other);
+
+		EntityStream(const EntityStream& other) = delete;
+		EntityStream& operator=(const EntityStream& other) = delete;
 
 		template <class... Types>
-		void init(uint64_t prototype);
+		void init(const ComponentMask& prototype);
+
+		void layout();
+
+		template <class T>
+		uint32_t column() const;
+
+		template <class T>
+		T* array(uint32_t chunk);
+
+		uint32_t size() const { return m_count; }
+		uint32_t chunk_count() const { return uint32_t(m_chunks.size()); }
+		uint32_t chunk_size(uint32_t chunk) const { return min(m_capacity, m_count - chunk * m_capacity); }
+
+		uint32_t* handles(uint32_t chunk) { return reinterpret_cast<uint32_t*>(m_chunks[chunk]); }
+		uint32_t chunk(uint32_t handle) { return this->index(handle) / m_capacity; }
+		uint32_t handle(uint32_t index) { return this->handles(index / m_capacity)[index % m_capacity]; }
+		uint32_t index(uint32_t handle);
+
+		void* at(uint32_t column, uint32_t index);
+#ifdef MUD_ECS_TYPED
+		Ref get(uint32_t column, uint32_t index);
+#endif
+
+		void clear();
+		void add(uint32_t handle, uint32_t version = 0);
+
+		// the components in moved were relocated out of the row by the caller, and are not destroyed
+		void remove(uint32_t handle, uint32_t version = 0, const ComponentMask& moved = {});
+		void erase(uint32_t index, uint32_t version = 0, const ComponentMask& moved = {});
+
+		// appends a row for handle, leaving its components unconstructed
+		uint32_t push(uint32_t handle, uint32_t version = 0);
+
+		// default constructs the component of a row
+		void construct(uint32_t column, uint32_t index);
+
+		uint32_t version(uint32_t chunk, uint32_t column) const { return m_versions[chunk * m_columns.size() + column]; }
+		bool changed(uint32_t chunk, const ComponentMask& components, uint32_t since) const;
+
+		void touch(uint32_t chunk, uint32_t column, uint32_t version) { m_versions[chunk * m_columns.size() + column] = version; }
+
+		template <class T>
+		void touch(uint32_t chunk, uint32_t version);
+
+		template <class T>
+		void set(uint32_t handle, T component = T());
 
-		cstring m_name;
-		uint64_t m_prototype;
+		template <class T>
+		T& get(uint32_t handle);
+
+		cstring m_name = nullptr;
+		ComponentMask m_prototype;
+
+		vector<ComponentColumn> m_columns;
+		// column of each component index in the stream, UINT16_MAX for components the stream doesn't have
+		vector<uint16_t> m_column_map;
+
+		// entities per chunk, and size of a chunk, which is only larger than CHUNK_SIZE when a single row doesn't fit
+		uint32_t m_capacity = 0;
+		uint32_t m_chunk_size = 0;
+		uint32_t m_count = 0;
+
+		// entity table of the owning ECS, where the row of each entity is stored
+		vector<EntityData>* m_entities = nullptr;
+		vector<char*> m_chunks;
+
+		// last version each component array of each chunk was written at, chunk major
+		vector<uint32_t> m_versions;
+
+		// last version rows were added, removed or reordered at
+		uint32_t m_rows_version = 0;
+		char* m_spare = nullptr;
+
+		// a default constructed row, copied over new slots of the trivially copyable components
+		char* m_defaults = nullptr;
+
+	private:
+		char* alloc_chunk();
+		void free_chunk(char* chunk);
 	};
 
 	class GridECS : public BufferArray<false>
@@ -100,7 +233,7 @@ namespace mud
 		void destroy(uint32_t handle);
 	};
 
-	class ECS
+	class MUD_ECS_EXPORT ECS
 	{
 	public:
 		uint32_t m_index = 0;
@@ -108,11 +241,24 @@ namespace mud
 		Typemap m_typemap;
 
 		vector<EntityStream> m_streams;
-		map<uint64_t, uint16_t> m_stream_map;
+		hash_map<ComponentMask, uint16_t> m_stream_map;
+
+		// descriptor of each component type present in a stream, indexed by component index
+		vector<ComponentColumn> m_components;
 
+		// stream and row of each entity, indexed by handle
 		vector<EntityData> m_entities;
 		vector<uint32_t> m_available;
 
+		// next handle never used, handles can be reserved from any thread
+		std::atomic<uint32_t> m_next = { 0 };
+
+		vector<unique<Query>> m_queries;
+		hash_map<QuerySignature, uint16_t> m_query_map;
+
+		// version stamped on the chunks when components are created, moved or accessed mutably
+		uint32_t m_version = 1;
+
 	public:
 		ECS(int capacity = 1 << 10);
 
@@ -123,18 +269,37 @@ namespace mud
 		uint32_t type_index();
 
 		template <class... Types>
-		uint64_t prototype();
+		ComponentMask prototype();
 
 		template <class... Types>
 		EntityStream& stream();
 
 		EntityStream& stream(uint32_t handle);
 
-		vector<EntityStream*> match(uint64_t prototype);
+		vector<EntityStream*> match(const ComponentMask& prototype);
+
+		Query& query(const QuerySignature& signature);
+
+		template <class... Types>
+		Query& query();
+
+		// starts a new version : a system keeps the version it ran at, and passes it as since on its next run to only visit what changed
+		uint32_t advance() { return ++m_version; }
 
 		template <class... Types>
 		void add_stream(cstring name);
 
+		uint16_t add_stream(EntityStream&& stream);
+
+		template <class... Types>
+		uint16_t stream_index();
+
+		// stream of prototype, created from the columns of the base stream and the added component if it doesn't exist
+		uint16_t stream_index(const ComponentMask& prototype, uint16_t base, const ComponentColumn* component = nullptr);
+
+		// stream of prototype, created from the known component descriptors if it doesn't exist, UINT16_MAX if one is unknown
+		uint16_t stream_index(const ComponentMask& prototype);
+
 #ifdef MUD_ECS_TYPED
 		template <class T>
 		void register_type();
@@ -143,15 +308,44 @@ namespace mud
 		void add_stream();
 #endif
 
-		void ensure_size();
+		uint32_t alloc(uint16_t stream);
 
-		uint32_t alloc(uint64_t prototype, uint16_t stream);
+		// reserves a range of handles, thread-safe : the entities are created later with insert()
+		uint32_t reserve(uint32_t count = 1);
 
 		template <class... Types>
 		uint32_t create();
 
+		void insert(uint32_t handle, uint16_t stream);
+
 		void destroy(uint32_t handle);
 
+		bool alive(uint32_t handle) const { return handle < m_entities.size() && m_entities[handle].m_stream != UINT16_MAX; }
+
+		const ComponentMask& prototype(uint32_t handle) const { return m_streams[m_entities[handle].m_stream].m_prototype; }
+
+		// moves an entity to the stream of prototype, component is the one added if any
+		void migrate(uint32_t handle, const ComponentMask& prototype, const ComponentColumn* component = nullptr);
+
+		// adds and removes components on a batch of entities : rows are moved in bulk per source stream, only the shared components are moved
+		// the added components must be known to the ecs, except component, which is the column of one that might not be yet
+		void migrate(span<uint32_t> handles, const ComponentMask& add, const ComponentMask& remove, const ComponentColumn* component = nullptr);
+
+		// relocates a component value into the entity, the value is left destroyed
+		void write(uint32_t handle, const ComponentColumn& component, void* value);
+
+		template <class T>
+		void add(uint32_t handle, T component = T());
+
+		template <class T>
+		void add(span<uint32_t> handles);
+
+		template <class T>
+		void remove(uint32_t handle);
+
+		template <class T>
+		void remove(span<uint32_t> handles);
+
 		template <class T>
 		void set(uint32_t handle, T component = T());
 
@@ -167,8 +361,14 @@ namespace mud
 		template <class... Types, class T_Function>
 		void loop(T_Function action);
 
+		template <class... Types, class T_Function>
+		void loop(Query& query, T_Function action, uint32_t since = 0);
+
 		template <class... Types, class T_Function>
 		void loop_ent(T_Function action);
+
+		template <class... Types, class T_Function>
+		void loop_ent(Query& query, T_Function action, uint32_t since = 0);
 	};
 
 	export_ extern MUD_ECS_EXPORT ECS* s_ecs[256];
@@ -16,14 +16,6 @@ namespace mud
 		swallow{ (f(static_cast<Types&&>(xs)), 0)... };
 	}
 
-	template <class... Types>
-	uint64_t any_flags(Types... xs)
-	{
-		uint64_t flags = false;
-		for_each([&flags](uint64_t x) { flags = flags | x; }, xs...);
-		return flags;
-	}
-
 #ifdef _MSC_VER // sucks
 	template <class... Args>
 	struct select_last;
@@ -53,6 +45,25 @@ namespace mud
 	};
 #endif
 
+	template <class... Types>
+	inline QuerySignature with()
+	{
+		return { component_mask<Types...>(), {}, {} };
+	}
+
+	template <class... Types>
+	inline QuerySignature QuerySignature::without() const
+	{
+		return { m_with, m_without | component_mask<Types...>(), m_changed };
+	}
+
+	template <class... Types>
+	inline QuerySignature QuerySignature::changed() const
+	{
+		const ComponentMask changed = component_mask<Types...>();
+		return { m_with | changed, m_without, m_changed | changed };
+	}
+
 	template <bool Dense>
 	inline BufferArray<Dense>::BufferArray() {}
 	template <bool Dense>
@@ -164,17 +175,46 @@ namespace mud
 		return this->buffer<T>().m_data[index];
 	}
 
-	inline EntityStream::EntityStream() {}
-	inline EntityStream::EntityStream(cstring name, Typemap& typemap, uint32_t size)
-		: BufferArray<false>(typemap, size)
-		, m_name(name)
-	{}
-
 	template <class... Types>
-	inline void EntityStream::init(uint64_t prototype)
+	inline void EntityStream::init(const ComponentMask& prototype)
 	{
 		m_prototype = prototype;
-		swallow{ (this->add_buffer<Types>(), 0)... };
+		swallow{ (m_columns.push_back(component_column<Types>()), 0)... };
+		this->layout();
+	}
+
+	inline uint32_t EntityStream::index(uint32_t handle) { return (*m_entities)[handle].m_row; }
+
+	template <class T>
+	inline uint32_t EntityStream::column() const
+	{
+		return m_column_map[TypedBuffer<T>::index()];
+	}
+
+	template <class T>
+	inline T* EntityStream::array(uint32_t chunk)
+	{
+		return reinterpret_cast<T*>(m_chunks[chunk] + m_columns[this->column<T>()].m_offset);
+	}
+
+	template <class T>
+	inline void EntityStream::touch(uint32_t chunk, uint32_t version)
+	{
+		if constexpr(!is_const<T>)
+			this->touch(chunk, this->column<T>(), version);
+	}
+
+	template <class T>
+	inline void EntityStream::set(uint32_t handle, T component)
+	{
+		this->get<T>(handle) = move(component);
+	}
+
+	template <class T>
+	inline T& EntityStream::get(uint32_t handle)
+	{
+		const uint32_t index = this->index(handle);
+		return this->array<T>(index / m_capacity)[index % m_capacity];
 	}
 
 	inline GridECS::GridECS()
@@ -214,15 +254,15 @@ namespace mud
 	}
 
 	template <class... Types>
-	inline uint64_t ECS::prototype()
+	inline ComponentMask ECS::prototype()
 	{
-		return any_flags(1ULL << this->type_index<Types>()...);
+		return component_mask<Types...>();
 	}
 
 	template <class... Types>
 	inline EntityStream& ECS::stream()
 	{
-		uint64_t prototype = this->prototype<Types...>();
+		ComponentMask prototype = this->prototype<Types...>();
 		uint16_t stream = m_stream_map[prototype];
 		return m_streams[stream];
 	}
@@ -233,22 +273,52 @@ namespace mud
 		return m_streams[stream];
 	}
 
-	inline vector<EntityStream*> ECS::match(uint64_t prototype)
+	inline vector<EntityStream*> ECS::match(const ComponentMask& prototype)
 	{
 		vector<EntityStream*> matches;
 		for(EntityStream& buffers : m_streams)
-			if((buffers.m_prototype & prototype) == prototype)
+			if(contains(buffers.m_prototype, prototype))
 				matches.push_back(&buffers);
 		return matches;
 	}
 
+	inline Query& ECS::query(const QuerySignature& signature)
+	{
+		// looked up on every loop, so the queries are found by their signature rather than scanned
+		auto it = m_query_map.find(signature);
+		if(it != m_query_map.end())
+			return *m_queries[it->second];
+
+		m_query_map[signature] = uint16_t(m_queries.size());
+		m_queries.push_back(construct<Query>(signature));
+		Query& query = *m_queries.back();
+		for(uint16_t i = 0; i < uint16_t(m_streams.size()); ++i)
+			if(signature.match(m_streams[i].m_prototype))
+				query.m_streams.push_back(i);
+		return query;
+	}
+
+	template <class... Types>
+	inline Query& ECS::query()
+	{
+		return this->query(with<Types...>());
+	}
+
 	template <class... Types>
 	inline void ECS::add_stream(cstring name)
 	{
-		uint64_t prototype = this->prototype<Types...>();
-		m_stream_map[prototype] = uint16_t(m_streams.size());
-		m_streams.push_back({ name, m_typemap });
-		m_streams.back().init<Types...>(prototype);
+		EntityStream stream = { name };
+		stream.init<Types...>(this->prototype<Types...>());
+		this->add_stream(move(stream));
+	}
+
+	template <class... Types>
+	inline uint16_t ECS::stream_index()
+	{
+		ComponentMask prototype = this->prototype<Types...>();
+		if(m_stream_map.find(prototype) == m_stream_map.end())
+			this->add_stream<Types...>();
+		return m_stream_map[prototype];
 	}
 
 #ifdef MUD_ECS_TYPED
@@ -270,119 +340,162 @@ namespace mud
 	}
 #endif
 
-	inline void ECS::ensure_size()
+	inline uint32_t ECS::alloc(uint16_t stream)
 	{
-		for(auto& buffer : m_streams)
-			buffer.ensure(uint32_t(m_entities.size()));
+		const uint32_t handle = m_available.size() > 0 ? pop(m_available) : this->reserve();
+		if(handle >= m_entities.size())
+			m_entities.resize(handle + 1);
+		m_entities[handle].m_stream = stream;
+		return handle;
 	}
 
-	inline uint32_t ECS::alloc(uint64_t prototype, uint16_t stream)
+	inline uint32_t ECS::reserve(uint32_t count)
 	{
-		if(m_available.size() > 0)
-			return pop(m_available);
-		uint32_t handle = uint32_t(m_entities.size());
-		m_entities.push_back({ prototype, stream });
-		this->ensure_size();
-		return handle;
+		return m_next.fetch_add(count, std::memory_order_relaxed);
 	}
 
 	template <class... Types>
 	inline uint32_t ECS::create()
 	{
-		uint64_t prototype = this->prototype<Types...>();
-		if(m_stream_map.find(prototype) == m_stream_map.end())
-			this->add_stream<Types...>();
-		uint16_t stream = m_stream_map[prototype];
-		uint32_t handle = this->alloc(prototype, stream);
-		m_streams[stream].add(handle);
+		uint16_t stream = this->stream_index<Types...>();
+		uint32_t handle = this->alloc(stream);
+		m_streams[stream].add(handle, m_version);
 		return handle;
 	}
 
 	inline void ECS::destroy(uint32_t handle)
 	{
 		EntityData& entity = m_entities[handle];
-		m_streams[entity.m_stream].remove(handle);
+		m_streams[entity.m_stream].remove(handle, m_version);
+		entity = {};
 		m_available.push_back(handle);
 	}
 
+	template <class T>
+	inline void ECS::add(uint32_t handle, T component)
+	{
+		const ComponentColumn& column = component_desc<T>();
+		this->migrate({ &handle, 1 }, component_flag(column.m_index), {}, &column);
+		// write() leaves the value destroyed, and the parameter still goes out of scope
+		this->write(handle, column, &component);
+		new (stl::placeholder(), &component) T();
+	}
+
+	template <class T>
+	inline void ECS::add(span<uint32_t> handles)
+	{
+		const ComponentColumn& column = component_desc<T>();
+		this->migrate(handles, component_flag(column.m_index), {}, &column);
+	}
+
+	template <class T>
+	inline void ECS::remove(uint32_t handle)
+	{
+		this->migrate({ &handle, 1 }, {}, component_flag(this->type_index<T>()));
+	}
+
+	template <class T>
+	inline void ECS::remove(span<uint32_t> handles)
+	{
+		this->migrate(handles, {}, component_flag(this->type_index<T>()));
+	}
+
 	template <class T>
 	inline void ECS::set(uint32_t handle, T component)
 	{
 		EntityData& entity = m_entities[handle];
-		m_streams[entity.m_stream].set<T>(handle, move(component));
+		EntityStream& stream = m_streams[entity.m_stream];
+		stream.touch<T>(stream.chunk(handle), m_version);
+		stream.set<T>(handle, move(component));
 	}
 
 	template <class T>
 	inline bool ECS::has(uint32_t handle)
 	{
-		uint64_t flag = (1ULL << this->type_index<T>());
-		EntityData& entity = m_entities[handle];
-		return (entity.m_prototype & flag) != 0;
+		return this->prototype(handle).test(this->type_index<T>());
 	}
 
 	template <class T>
 	inline T& ECS::get(uint32_t handle)
 	{
 		EntityData& entity = m_entities[handle];
-		return m_streams[entity.m_stream].get<T>(handle);
+		EntityStream& stream = m_streams[entity.m_stream];
+		stream.touch<T>(stream.chunk(handle), m_version);
+		return stream.get<T>(handle);
 	}
 
 	template <class T, class... Types>
 	inline vector<T*> ECS::gather()
 	{
-		uint64_t prototype = this->prototype<T, Types...>();
-		
+		Query& query = this->query<T, Types...>();
+
 		vector<T*> result;
 
-		vector<EntityStream*> matches = this->match(prototype);
-		for(EntityStream* buffers : matches)
+		for(uint16_t index : query.m_streams)
 		{
-			TBuffer<T>& buffer = buffers->buffer<T>();
-
-			const size_t count = buffer.m_data.size();
-			const size_t size = result.size();
-			result.reserve(size + count);
+			EntityStream& stream = m_streams[index];
+			result.reserve(result.size() + stream.size());
 
-			for(size_t i = 0; i < count; ++i)
-				result.push_back(&buffer.m_data[size + i]);
+			for(uint32_t c = 0; c < stream.chunk_count(); ++c)
+			{
+				stream.touch<T>(c, m_version);
+				T* components = stream.array<T>(c);
+				const uint32_t count = stream.chunk_size(c);
+				for(uint32_t i = 0; i < count; ++i)
+					result.push_back(&components[i]);
+			}
 		}
 
 		return result;
 	}
 
 	template <class... Types, size_t... Is, class T_Function>
-	inline void loop_ent_impl(ECS& ecs, T_Function action, index_sequence<Is...>)
+	inline void loop_ent_impl(ECS& ecs, Query& query, uint32_t since, T_Function action, index_sequence<Is...>)
 	{
-		uint64_t prototype = ecs.prototype<Types...>();
+		const ComponentMask& changed = query.m_signature.tracked();
 
-		vector<EntityStream*> matches = ecs.match(prototype);
-		for(EntityStream* stream : matches)
+		for(uint16_t index : query.m_streams)
 		{
-			tuple<TBuffer<Types>&...> buffers = { stream->buffer<Types>()... };
-
-			const uint32_t size = stream->size();
-			for(uint32_t i = 0; i < size; ++i)
+			EntityStream& stream = ecs.m_streams[index];
+			for(uint32_t c = 0; c < stream.chunk_count(); ++c)
 			{
-				uint32_t handle = stream->handle(i);
-				action(handle, at<Is>(buffers).m_data[i]...);
+				if(since && !stream.changed(c, changed, since))
+					continue;
+
+				swallow{ (stream.touch<Types>(c, ecs.m_version), 0)... };
+				tuple<Types*...> arrays = { stream.array<Types>(c)... };
+				uint32_t* handles = stream.handles(c);
+
+				const uint32_t count = stream.chunk_size(c);
+				for(uint32_t i = 0; i < count; ++i)
+				{
+					action(handles[i], at<Is>(arrays)[i]...);
+				}
 			}
 		}
 	}
 
 	template <class... Types, size_t... Is, class T_Function>
-	inline void loop_impl(ECS& ecs, T_Function action, index_sequence<Is...>)
+	inline void loop_impl(ECS& ecs, Query& query, uint32_t since, T_Function action, index_sequence<Is...>)
 	{
-		uint64_t prototype = ecs.prototype<Types...>();
+		const ComponentMask& changed = query.m_signature.tracked();
 
-		vector<EntityStream*> matches = ecs.match(prototype);
-		for(EntityStream* stream : matches)
+		for(uint16_t index : query.m_streams)
 		{
-			tuple<TBuffer<Types>&...> buffers = { stream->buffer<Types>()... };
-
-			const uint32_t size = stream->size();
-			for(uint32_t i = 0; i < size; ++i)
+			EntityStream& stream = ecs.m_streams[index];
+			for(uint32_t c = 0; c < stream.chunk_count(); ++c)
 			{
-				action(at<Is>(buffers).m_data[i]...);
+				if(since && !stream.changed(c, changed, since))
+					continue;
+
+				swallow{ (stream.touch<Types>(c, ecs.m_version), 0)... };
+				tuple<Types*...> arrays = { stream.array<Types>(c)... };
+
+				const uint32_t count = stream.chunk_size(c);
+				for(uint32_t i = 0; i < count; ++i)
+				{
+					action(at<Is>(arrays)[i]...);
+				}
 			}
 		}
 	}
@@ -390,13 +503,25 @@ namespace mud
 	template <class... Types, class T_Function>
 	inline void ECS::loop(T_Function action)
 	{
-		loop_impl<Types...>(*this, action, index_tuple<sizeof...(Types)>());
+		loop_impl<Types...>(*this, this->query<Types...>(), 0, action, index_tuple<sizeof...(Types)>());
+	}
+
+	template <class... Types, class T_Function>
+	inline void ECS::loop(Query& query, T_Function action, uint32_t since)
+	{
+		loop_impl<Types...>(*this, query, since, action, index_tuple<sizeof...(Types)>());
 	}
 
 	template <class... Types, class T_Function>
 	inline void ECS::loop_ent(T_Function action)
 	{
-		loop_ent_impl<Types...>(*this, action, index_tuple<sizeof...(Types)>());
+		loop_ent_impl<Types...>(*this, this->query<Types...>(), 0, action, index_tuple<sizeof...(Types)>());
+	}
+
+	template <class... Types, class T_Function>
+	inline void ECS::loop_ent(Query& query, T_Function action, uint32_t since)
+	{
+		loop_ent_impl<Types...>(*this, query, since, action, index_tuple<sizeof...(Types)>());
 	}
 
 	template <class T>
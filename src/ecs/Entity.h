@@ -14,6 +14,11 @@ namespace mud
 	struct TypedBuffer
 	{};
 
+	// read-only access to a component, which doesn't mark it as changed
+	template <class T>
+	struct TypedBuffer<const T> : public TypedBuffer<T>
+	{};
+
 	struct refl_ struct_ MUD_ECS_EXPORT Entity
 	{
 		Entity() {}
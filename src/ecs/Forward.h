@@ -17,6 +17,11 @@ namespace mud
     class Prototype;
 	struct Entity;
 	class ECS;
+	class Query;
+	class CommandBuffer;
+	class CommandBuffers;
+	class System;
+	class SystemScheduler;
 	class GridECS;
 	class Complex;
 }
@@ -8,27 +8,38 @@
 namespace mud
 {
 	template <class... Types, size_t... Is, class T_Function>
-	Job* for_components_impl(JobSystem& job_system, Job* parent, ECS& ecs, T_Function action, index_sequence<Is...>)
+	Job* for_components_impl(JobSystem& job_system, Job* parent, ECS& ecs, Query& query, uint32_t since, T_Function action, index_sequence<Is...>)
 	{
-		uint64_t prototype = ecs.prototype<Types...>();
-
 		Job* job = job_system.job(parent);
 
-		vector<EntityStream*> matches = ecs.match(prototype);
-		for(EntityStream* stream : matches)
+		const ComponentMask changed = query.m_signature.tracked();
+		const uint32_t version = ecs.m_version;
+
+		for(uint16_t index : query.m_streams)
 		{
-			tuple<TBuffer<Types>&...> buffers = { stream->buffer<Types>()... };
+			EntityStream* stream = &ecs.m_streams[index];
 
+			// chunks are the unit of work : each job processes a range of whole chunks
 			auto process = [=](JobSystem& js, Job* job, uint32_t start, uint32_t count)
 			{
 				UNUSED(js); UNUSED(job);
-				for(uint32_t i = start; i < start + count; ++i)
+				for(uint32_t c = start; c < start + count; ++c)
 				{
-					action(at<Is>(buffers).m_data[i]...);
+					if(since && !stream->changed(c, changed, since))
+						continue;
+
+					swallow{ (stream->touch<Types>(c, version), 0)... };
+					tuple<Types*...> arrays = { stream->array<Types>(c)... };
+
+					const uint32_t size = stream->chunk_size(c);
+					for(uint32_t i = 0; i < size; ++i)
+					{
+						action(at<Is>(arrays)[i]...);
+					}
 				}
 			};
 
-			Job* stream_job = split_jobs<64>(job_system, job, 0, uint32_t(stream->size()), process);
+			Job* stream_job = split_jobs<1>(job_system, job, 0, stream->chunk_count(), process);
 			job_system.run(stream_job);
 		}
 
@@ -38,6 +49,12 @@ namespace mud
 	template <class... Types, class T_Function>
 	Job* for_components(JobSystem& job_system, Job* parent, ECS& ecs, T_Function action)
 	{
-		return for_components_impl<Types...>(job_system, parent, ecs, action, index_tuple<sizeof...(Types)>());
+		return for_components_impl<Types...>(job_system, parent, ecs, ecs.query<Types...>(), 0, action, index_tuple<sizeof...(Types)>());
+	}
+
+	template <class... Types, class T_Function>
+	Job* for_components(JobSystem& job_system, Job* parent, ECS& ecs, Query& query, T_Function action, uint32_t since = 0)
+	{
+		return for_components_impl<Types...>(job_system, parent, ecs, query, since, action, index_tuple<sizeof...(Types)>());
 	}
 }
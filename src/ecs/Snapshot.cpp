@@ -0,0 +1,377 @@
+//  Copyright (c) 2019 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <infra/Cpp20.h>
+
+#ifdef MUD_MODULES
+module mud.ecs;
+#else
+#include <stl/vector.hpp>
+#include <infra/File.h>
+#include <ecs/ECS.h>
+#include <ecs/ECS.hpp>
+#include <ecs/Snapshot.h>
+#endif
+
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+namespace mud
+{
+	namespace
+	{
+		constexpr uint32_t c_magic = 0x5344554d; // MUDS
+		constexpr uint32_t c_format = 1;
+
+		struct SnapshotHeader
+		{
+			uint32_t m_magic;
+			uint32_t m_format;
+			// version the delta applies over, 0 for a full snapshot
+			uint32_t m_since;
+			uint32_t m_version;
+			uint32_t m_next;
+			uint32_t m_streams;
+		};
+
+		// a full stream record is followed by the handles and all the rows, a partial one by its blocks
+		struct StreamHeader
+		{
+			ComponentMask m_prototype;
+			uint32_t m_columns;
+			uint32_t m_count;
+			uint32_t m_full;
+			uint32_t m_blocks;
+		};
+
+		struct ColumnLayout
+		{
+			uint32_t m_index;
+			uint32_t m_size;
+			uint32_t m_align;
+			uint32_t m_trivial;
+		};
+
+		// a range of rows of one column of the stream record
+		struct BlockHeader
+		{
+			uint32_t m_column;
+			uint32_t m_first;
+			uint32_t m_count;
+		};
+
+		struct Writer
+		{
+			vector<uint8_t>& m_data;
+
+			void write(const void* data, size_t size)
+			{
+				const size_t offset = m_data.size();
+				if(offset + size > m_data.capacity())
+					m_data.reserve(max(m_data.capacity() * 2, offset + size));
+				m_data.resize(offset + size);
+				memcpy(m_data.data() + offset, data, size);
+			}
+
+			template <class T>
+			void write(const T& value) { this->write(&value, sizeof(T)); }
+		};
+
+		struct Reader
+		{
+			span<uint8_t> m_data;
+			size_t m_offset = 0;
+			bool m_error = false;
+
+			uint8_t* bytes(size_t size)
+			{
+				if(m_error || m_offset + size > m_data.size())
+				{
+					m_error = true;
+					return nullptr;
+				}
+				uint8_t* at = m_data.data() + m_offset;
+				m_offset += size;
+				return at;
+			}
+
+			template <class T>
+			bool read(T& value)
+			{
+				const uint8_t* at = this->bytes(sizeof(T));
+				if(at)
+					memcpy(&value, at, sizeof(T));
+				return at != nullptr;
+			}
+		};
+
+		// trivial rows are written as one block per chunk they span, the others as a size and the bytes of the serializer
+		void write_rows(Writer& writer, EntityStream& stream, uint32_t column, uint32_t first, uint32_t count, const ComponentSerializer& serializer)
+		{
+			const ComponentColumn& c = stream.m_columns[column];
+			if(c.m_trivial)
+			{
+				for(uint32_t row = first, run = 0; row < first + count; row += run)
+				{
+					run = min(first + count - row, stream.m_capacity - row % stream.m_capacity);
+					writer.write(stream.at(column, row), run * c.m_size);
+				}
+				return;
+			}
+
+			vector<uint8_t> value;
+			for(uint32_t row = first; row < first + count; ++row)
+			{
+				value.clear();
+				if(serializer.m_save)
+					serializer.m_save(c, stream.at(column, row), value);
+				writer.write(uint32_t(value.size()));
+				writer.write(value.data(), value.size());
+			}
+		}
+
+		bool read_rows(Reader& reader, EntityStream& stream, uint32_t column, uint32_t first, uint32_t count, const ComponentSerializer& serializer)
+		{
+			const ComponentColumn& c = stream.m_columns[column];
+			if(c.m_trivial)
+			{
+				for(uint32_t row = first, run = 0; row < first + count; row += run)
+				{
+					run = min(first + count - row, stream.m_capacity - row % stream.m_capacity);
+					const uint8_t* data = reader.bytes(run * c.m_size);
+					if(!data)
+						return false;
+					memcpy(stream.at(column, row), data, run * c.m_size);
+				}
+				return true;
+			}
+
+			for(uint32_t row = first; row < first + count; ++row)
+			{
+				uint32_t size = 0;
+				uint8_t* data = reader.read(size) ? reader.bytes(size) : nullptr;
+				if(!data)
+					return false;
+				if(serializer.m_load && size > 0)
+					serializer.m_load(c, stream.at(column, row), { data, size });
+			}
+			return true;
+		}
+
+		void clear_rows(ECS& ecs, EntityStream& stream)
+		{
+			for(uint32_t i = 0; i < stream.size(); ++i)
+				ecs.m_entities[stream.handle(i)].m_stream = UINT16_MAX;
+			stream.clear();
+			stream.m_rows_version = ecs.m_version;
+		}
+
+		bool load_stream(ECS& ecs, Reader& reader, const ComponentSerializer& serializer)
+		{
+			StreamHeader header;
+			if(!reader.read(header))
+				return false;
+
+			const uint16_t index = ecs.stream_index(header.m_prototype);
+			if(index == UINT16_MAX)
+			{
+				printf("ERROR: snapshot has a component unknown to the ECS\n");
+				return false;
+			}
+
+			EntityStream& stream = ecs.m_streams[index];
+			const uint32_t version = ecs.m_version;
+
+			// columns of the record mapped to the columns of the stream, which might be laid out in another order
+			vector<uint32_t> columns(header.m_columns);
+			for(uint32_t c = 0; c < header.m_columns; ++c)
+			{
+				ColumnLayout layout;
+				if(!reader.read(layout))
+					return false;
+				const uint16_t column = layout.m_index < stream.m_column_map.size() ? stream.m_column_map[layout.m_index] : uint16_t(UINT16_MAX);
+				if(column == UINT16_MAX || stream.m_columns[column].m_size != layout.m_size || uint32_t(stream.m_columns[column].m_trivial) != layout.m_trivial)
+				{
+					printf("ERROR: snapshot component %u doesn't match the layout of the ECS component\n", layout.m_index);
+					return false;
+				}
+				columns[c] = column;
+			}
+
+			if(header.m_full)
+			{
+				clear_rows(ecs, stream);
+
+				const uint8_t* handles = reader.bytes(header.m_count * sizeof(uint32_t));
+				if(!handles)
+					return false;
+
+				for(uint32_t i = 0; i < header.m_count; ++i)
+				{
+					uint32_t handle;
+					memcpy(&handle, handles + i * sizeof(uint32_t), sizeof(uint32_t));
+					if(handle >= ecs.m_entities.size())
+						ecs.m_entities.resize(handle + 1);
+					// an entity that moved is still in its previous stream, if the record of that stream comes later
+					else if(ecs.alive(handle))
+						ecs.m_streams[ecs.m_entities[handle].m_stream].remove(handle, version);
+					ecs.m_entities[handle].m_stream = index;
+					stream.push(handle, version);
+				}
+
+				// the other components are constructed before reading, so that the rows are valid even if reading fails
+				for(uint32_t c = 0; c < uint32_t(stream.m_columns.size()); ++c)
+					if(!stream.m_columns[c].m_trivial)
+						for(uint32_t row = 0; row < header.m_count; ++row)
+							stream.construct(c, row);
+
+				for(uint32_t c = 0; c < header.m_columns; ++c)
+					if(!read_rows(reader, stream, columns[c], 0, header.m_count, serializer))
+						return false;
+				return true;
+			}
+
+			for(uint32_t b = 0; b < header.m_blocks; ++b)
+			{
+				BlockHeader block;
+				if(!reader.read(block))
+					return false;
+				if(block.m_count == 0)
+					continue;
+				if(block.m_column >= header.m_columns || block.m_first + block.m_count > stream.size())
+				{
+					printf("ERROR: snapshot delta doesn't apply over the current rows\n");
+					return false;
+				}
+
+				const uint32_t column = columns[block.m_column];
+				if(!read_rows(reader, stream, column, block.m_first, block.m_count, serializer))
+					return false;
+
+				const uint32_t last = block.m_first + block.m_count - 1;
+				for(uint32_t chunk = block.m_first / stream.m_capacity; chunk <= last / stream.m_capacity; ++chunk)
+					stream.touch(chunk, column, version);
+			}
+			return true;
+		}
+	}
+
+	uint32_t save_delta(ECS& ecs, uint32_t since, vector<uint8_t>& data, const ComponentSerializer& serializer)
+	{
+		const uint32_t version = ecs.m_version;
+
+		data.clear();
+		Writer writer = { data };
+		writer.write(SnapshotHeader{ c_magic, c_format, since, version, ecs.m_next.load(), 0 });
+
+		uint32_t count = 0;
+		vector<BlockHeader> blocks;
+		for(EntityStream& stream : ecs.m_streams)
+		{
+			const bool full = since == 0 || stream.m_rows_version > since;
+
+			// rows didn't move since the version : the chunks written since are patched in place
+			blocks.clear();
+			if(!full)
+				for(uint32_t chunk = 0; chunk < stream.chunk_count(); ++chunk)
+					for(uint32_t c = 0; c < uint32_t(stream.m_columns.size()); ++c)
+						if(stream.version(chunk, c) > since)
+							blocks.push_back({ c, chunk * stream.m_capacity, stream.chunk_size(chunk) });
+
+			if(!full && blocks.empty())
+				continue;
+
+			count++;
+			writer.write(StreamHeader{ stream.m_prototype, uint32_t(stream.m_columns.size()), stream.size(), uint32_t(full), uint32_t(blocks.size()) });
+			for(const ComponentColumn& column : stream.m_columns)
+				writer.write(ColumnLayout{ column.m_index, column.m_size, column.m_align, uint32_t(column.m_trivial) });
+
+			if(full)
+			{
+				for(uint32_t chunk = 0; chunk < stream.chunk_count(); ++chunk)
+					writer.write(stream.handles(chunk), stream.chunk_size(chunk) * sizeof(uint32_t));
+				for(uint32_t c = 0; c < uint32_t(stream.m_columns.size()); ++c)
+					write_rows(writer, stream, c, 0, stream.size(), serializer);
+			}
+
+			for(const BlockHeader& block : blocks)
+			{
+				writer.write(block);
+				write_rows(writer, stream, block.m_column, block.m_first, block.m_count, serializer);
+			}
+		}
+
+		memcpy(data.data() + offsetof(SnapshotHeader, m_streams), &count, sizeof(uint32_t));
+
+		ecs.advance();
+		return version;
+	}
+
+	uint32_t save_snapshot(ECS& ecs, vector<uint8_t>& data, const ComponentSerializer& serializer)
+	{
+		return save_delta(ecs, 0, data, serializer);
+	}
+
+	bool load_snapshot(ECS& ecs, span<uint8_t> data, const ComponentSerializer& serializer)
+	{
+		Reader reader = { data };
+
+		SnapshotHeader header;
+		if(!reader.read(header) || header.m_magic != c_magic || header.m_format != c_format)
+		{
+			printf("ERROR: data is not a snapshot, or was written with another format version\n");
+			return false;
+		}
+
+		// loaded chunks are stamped with the live version : it never goes backwards, or systems holding a since would miss the writes that follow
+		if(header.m_version > ecs.m_version)
+			ecs.m_version = header.m_version;
+
+		if(header.m_since == 0)
+			for(EntityStream& stream : ecs.m_streams)
+				clear_rows(ecs, stream);
+
+		for(uint32_t s = 0; s < header.m_streams; ++s)
+			if(!load_stream(ecs, reader, serializer))
+			{
+				if(reader.m_error)
+					printf("ERROR: snapshot is truncated\n");
+				return false;
+			}
+
+		// handles that are in no stream are free
+		if(header.m_next > ecs.m_next)
+			ecs.m_next = header.m_next;
+		if(ecs.m_entities.size() < ecs.m_next)
+			ecs.m_entities.resize(ecs.m_next);
+
+		ecs.m_available.clear();
+		for(uint32_t handle = uint32_t(ecs.m_entities.size()); handle > 0; --handle)
+			if(!ecs.alive(handle - 1))
+				ecs.m_available.push_back(handle - 1);
+
+		ecs.advance();
+		return true;
+	}
+
+	uint32_t save_snapshot(ECS& ecs, const string& path, const ComponentSerializer& serializer)
+	{
+		vector<uint8_t> data;
+		const uint32_t version = save_snapshot(ecs, data, serializer);
+		write_binary_file(path, data);
+		return version;
+	}
+
+	bool load_snapshot(ECS& ecs, const string& path, const ComponentSerializer& serializer)
+	{
+		MappedFile file(path);
+		if(!file.m_data)
+		{
+			printf("ERROR: could not open snapshot %s\n", path.c_str());
+			return false;
+		}
+		return load_snapshot(ecs, file.data(), serializer);
+	}
+}
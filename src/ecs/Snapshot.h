@@ -0,0 +1,38 @@
+#pragma once
+
+#include <stl/vector.h>
+#include <stl/string.h>
+#include <stl/span.h>
+#include <stl/function.h>
+#include <ecs/Forward.h>
+#include <ecs/Chunk.h>
+
+#include <stdint.h>
+
+namespace mud
+{
+	// writes and reads back the components that are not trivially copyable, which can't be stored as raw bytes
+	// a reflection based serializer can pack Ref(value, *column.m_type) to json with srlz
+	struct ComponentSerializer
+	{
+		function<void(const ComponentColumn& column, void* value, vector<uint8_t>& data)> m_save;
+		function<void(const ComponentColumn& column, void* value, span<uint8_t> data)> m_load;
+	};
+
+	// binary world snapshot : each stream is written as its handles followed by one contiguous block per component
+	// a header describes the layout of each component, trivially copyable components are written as raw bytes and read back with one memcpy per chunk
+	//
+	// a delta since a version only holds the streams whose rows changed, in full, and the chunks of the other streams written since
+	// it applies over the world as it was at that version, like a full snapshot of that version, or the previous delta
+	// saving starts a new version, the next delta is taken since the version returned
+	export_ MUD_ECS_EXPORT uint32_t save_snapshot(ECS& ecs, vector<uint8_t>& data, const ComponentSerializer& serializer = {});
+	export_ MUD_ECS_EXPORT uint32_t save_delta(ECS& ecs, uint32_t since, vector<uint8_t>& data, const ComponentSerializer& serializer = {});
+
+	// loads a full snapshot, replacing all entities, or applies a delta
+	// the ECS must know the descriptors of all components in the snapshot, from streams created from them
+	export_ MUD_ECS_EXPORT bool load_snapshot(ECS& ecs, span<uint8_t> data, const ComponentSerializer& serializer = {});
+
+	export_ MUD_ECS_EXPORT uint32_t save_snapshot(ECS& ecs, const string& path, const ComponentSerializer& serializer = {});
+	// the file is mapped in memory and copied straight from the mapping
+	export_ MUD_ECS_EXPORT bool load_snapshot(ECS& ecs, const string& path, const ComponentSerializer& serializer = {});
+}
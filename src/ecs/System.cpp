@@ -0,0 +1,141 @@
+//  Copyright (c) 2019 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#include <infra/Cpp20.h>
+
+#ifdef MUD_MODULES
+module mud.ecs;
+#else
+#include <stl/vector.hpp>
+#include <jobs/JobSystem.h>
+#include <jobs/Job.h>
+#include <jobs/JobTrace.h>
+#include <ecs/ECS.h>
+#include <ecs/System.h>
+#endif
+
+#include <cstdio>
+
+namespace mud
+{
+	SystemScheduler::SystemScheduler(ECS& ecs)
+		: m_ecs(ecs)
+	{}
+
+	SystemScheduler::~SystemScheduler()
+	{}
+
+	System& SystemScheduler::add(cstring name, const SystemAccess& access, SystemFunc run)
+	{
+		m_systems.push_back(construct<System>());
+		System& system = *m_systems.back();
+		system.m_name = name;
+		system.m_access = access;
+		system.m_run = run;
+		m_dirty = true;
+		return system;
+	}
+
+	void SystemScheduler::build()
+	{
+		const uint32_t count = uint32_t(m_systems.size());
+
+		// reachable[i] holds every system that is guaranteed to complete before system i starts
+		vector<vector<bool>> reachable(count, vector<bool>(count, false));
+
+		m_predecessors.clear();
+		m_predecessors.resize(count);
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			// latest first, so that earlier conflicts are usually already implied by a later one
+			for(uint32_t j = i; j-- > 0;)
+			{
+				if(reachable[i][j] || !m_systems[i]->m_access.conflicts(m_systems[j]->m_access))
+					continue;
+
+				m_predecessors[i].push_back(j);
+				reachable[i][j] = true;
+				for(uint32_t k = 0; k < j; ++k)
+					if(reachable[j][k])
+						reachable[i][k] = true;
+			}
+		}
+
+		m_dirty = false;
+	}
+
+	Job* SystemScheduler::schedule(JobSystem& js, Job* parent)
+	{
+		if(m_dirty)
+			this->build();
+
+		m_since = m_version ? m_version - 1 : 0;
+		m_version = m_ecs.advance();
+
+		Job* root = js.job(parent);
+		const uint32_t count = uint32_t(m_systems.size());
+
+		// a job can only have a few continuations : when a system has too many successors, they hang from relay jobs
+		// jobs can't be depended on once they run, so they are all run after the graph is wired
+		struct Node { Job* m_job; uint32_t m_successors; };
+		vector<Node> nodes(count);
+		vector<Job*> jobs;
+
+		auto depend = [&](Job* job, Node& node)
+		{
+			if(node.m_successors == JobSystem::MAX_CONTINUATIONS - 1)
+			{
+				Job* relay = js.job(root);
+				js.depend(relay, node.m_job);
+				jobs.push_back(relay);
+				node = { relay, 0 };
+			}
+			js.depend(job, node.m_job);
+			node.m_successors++;
+		};
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			System* system = m_systems[i].get();
+			Job* job = js.job(root, [system](JobSystem& js, Job* job)
+			{
+				system->m_begin = JobTracer::now();
+				system->m_run(js, job);
+			});
+
+			Job* done = js.job(root, [system](JobSystem&, Job*)
+			{
+				system->m_time = JobTracer::now() - system->m_begin;
+				system->m_total += system->m_time;
+				system->m_runs++;
+			});
+
+			nodes[i] = { job, 0 };
+			depend(done, nodes[i]);
+			jobs.push_back(job);
+			jobs.push_back(done);
+
+			for(uint32_t predecessor : m_predecessors[i])
+				depend(job, nodes[predecessor]);
+		}
+
+		for(Job* job : jobs)
+			js.run(job);
+
+		return root;
+	}
+
+	void SystemScheduler::run(JobSystem& js)
+	{
+		alloc_scope tag(alloc_tag::ecs);
+		js.complete(this->schedule(js));
+	}
+
+	void SystemScheduler::log_timings() const
+	{
+		for(const unique<System>& system : m_systems)
+			printf("INFO: system %-24s last %8.3f ms, average %8.3f ms over %u runs\n", system->m_name,
+				   double(system->m_time) / 1e6, system->m_runs ? double(system->m_total) / double(system->m_runs) / 1e6 : 0.0, system->m_runs);
+	}
+}
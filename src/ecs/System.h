@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stl/vector.h>
+#include <stl/memory.h>
+#include <stl/function.h>
+#include <jobs/Forward.h>
+#include <ecs/Forward.h>
+#include <ecs/Chunk.h>
+
+#include <stdint.h>
+
+namespace mud
+{
+	// components a system reads and writes : two systems conflict when one of them writes what the other accesses
+	struct SystemAccess
+	{
+		ComponentMask m_read;
+		ComponentMask m_write;
+
+		bool conflicts(const SystemAccess& other) const { return (m_write & (other.m_read | other.m_write)).any() || (other.m_write & m_read).any(); }
+	};
+
+	// const components are read, the others are written
+	template <class... Types>
+	SystemAccess system_access();
+
+	using SystemFunc = function<void(JobSystem&, Job*)>;
+
+	class System
+	{
+	public:
+		cstring m_name;
+		SystemAccess m_access;
+
+		// called from the system job, the work it spawns as children of the job is part of the system
+		SystemFunc m_run;
+
+		// duration of the last run, from the start of the system job to the completion of all its children, in nanoseconds
+		uint64_t m_begin = 0;
+		uint64_t m_time = 0;
+		uint64_t m_total = 0;
+		uint32_t m_runs = 0;
+	};
+
+	// runs the registered systems as jobs : systems that don't conflict run concurrently, conflicting ones in the order they were added
+	class MUD_ECS_EXPORT SystemScheduler
+	{
+	public:
+		SystemScheduler(ECS& ecs);
+		~SystemScheduler();
+
+		System& add(cstring name, const SystemAccess& access, SystemFunc run);
+
+		// action is called with the components of each matching entity, the matched streams are split across workers by chunks
+		template <class... Types, class T_Function>
+		System& add(cstring name, T_Function action);
+
+		// with a query declaring changed<> components, only the chunks written since the previous run are visited
+		template <class... Types, class T_Function>
+		System& add(cstring name, Query& query, T_Function action);
+
+		// returns the job running all systems, it must still be run
+		Job* schedule(JobSystem& js, Job* parent = nullptr);
+
+		void run(JobSystem& js);
+
+		void log_timings() const;
+
+		ECS& m_ecs;
+		vector<unique<System>> m_systems;
+
+		// version of the ECS at the start of the last run, changed<> queries visit what was written since the start of the previous one
+		uint32_t m_version = 0;
+		uint32_t m_since = 0;
+
+	private:
+		void build();
+
+		// conflicting systems added earlier that a system must wait for, without those already implied transitively
+		vector<vector<uint32_t>> m_predecessors;
+		bool m_dirty = true;
+	};
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <ecs/System.h>
+#include <ecs/Loop.hpp>
+
+namespace mud
+{
+	template <class... Types>
+	inline SystemAccess system_access()
+	{
+		SystemAccess access;
+		swallow{ ((is_const<Types> ? access.m_read : access.m_write).set(TypedBuffer<Types>::index()), 0)... };
+		return access;
+	}
+
+	template <class... Types, class T_Function>
+	inline System& SystemScheduler::add(cstring name, T_Function action)
+	{
+		return this->add<Types...>(name, m_ecs.query<Types...>(), action);
+	}
+
+	template <class... Types, class T_Function>
+	inline System& SystemScheduler::add(cstring name, Query& query, T_Function action)
+	{
+		ECS* ecs = &m_ecs;
+		Query* q = &query;
+		uint32_t* since = &m_since;
+		return this->add(name, system_access<Types...>(), [=](JobSystem& js, Job* job)
+		{
+			js.run(for_components<Types...>(js, job, *ecs, *q, action, q->m_signature.m_changed.any() ? *since : 0));
+		});
+	}
+}
@@ -3,6 +3,8 @@
 module mud.ecs;
 #else
 #include <stl/vector.hpp>
+#include <stl/unordered_map.hpp>
+#include <stl/flat_map.hpp>
 #include <ecs/Api.h>
 #include <ecs/ECS.hpp>
 #endif
@@ -15,5 +17,19 @@ namespace stl
 	template class MUD_ECS_EXPORT vector<EntityData>;
 	template class MUD_ECS_EXPORT vector<EntityStream>;
 	template class MUD_ECS_EXPORT vector<unique<Buffer>>;
+	template class MUD_ECS_EXPORT vector<ComponentColumn>;
+	template class MUD_ECS_EXPORT vector<unique<Query>>;
+	template class MUD_ECS_EXPORT vector<EntityCommand>;
+	template class MUD_ECS_EXPORT vector<unique<CommandBuffer>>;
+#ifdef MUD_CHAINED_MAPS
+	template class MUD_ECS_EXPORT unordered_map<ComponentMask, uint16_t>;
+	template class MUD_ECS_EXPORT unordered_map<QuerySignature, uint16_t>;
+#else
+	template class MUD_ECS_EXPORT flat_table<ComponentMask, pair<ComponentMask, uint16_t>>;
+	template class MUD_ECS_EXPORT flat_map<ComponentMask, uint16_t>;
+	template class MUD_ECS_EXPORT flat_table<QuerySignature, pair<QuerySignature, uint16_t>>;
+	template class MUD_ECS_EXPORT flat_map<QuerySignature, uint16_t>;
+#endif
+	template class MUD_ECS_EXPORT vector<unique<System>>;
 }
 #endif
@@ -280,14 +280,14 @@ namespace gfx
 
 	PassOpaque::PassOpaque(GfxSystem& gfx_system)
 		: DrawPass(gfx_system, "opaque", PassType::Opaque)
-	{}
+	{
+		m_draw_order = DrawOrder::FrontToBack;
+	}
 
 	void PassOpaque::next_draw_pass(Render& render, Pass& render_pass)
 	{
 		UNUSED(render);
 
-		bgfx::setViewMode(render_pass.m_index, bgfx::ViewMode::DepthAscending);
-
 #if DEPTH_PASS
 		render_pass.m_bgfx_state = 0 | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_DEPTH_TEST_EQUAL
 								     | BGFX_STATE_WRITE_Z | BGFX_STATE_CULL_CW | BGFX_STATE_MSAA;
@@ -311,15 +311,15 @@ namespace gfx
 
 	PassAlpha::PassAlpha(GfxSystem& gfx_system)
 		: DrawPass(gfx_system, "alpha", PassType::Alpha)
-	{}
+	{
+		m_draw_order = DrawOrder::BackToFront;
+	}
 
 	void PassAlpha::next_draw_pass(Render& render, Pass& render_pass)
 	{
 		UNUSED(render);
 
 		render_pass.m_bgfx_state = MUD_GFX_STATE_DEFAULT_ALPHA;
-
-		bgfx::setViewMode(render_pass.m_index, bgfx::ViewMode::DepthDescending);
 	}
 
 	void PassAlpha::queue_draw_element(Render& render, DrawElement& element)
@@ -336,13 +336,12 @@ namespace gfx
 	PassGeometry::PassGeometry(GfxSystem& gfx_system, BlockGeometry& block_geometry)
 		: DrawPass(gfx_system, "geometry", PassType::Geometry)
 		, m_block_geometry(block_geometry)
-	{}
+	{
+		m_draw_order = DrawOrder::FrontToBack;
+	}
 
 	void PassGeometry::next_draw_pass(Render& render, Pass& render_pass)
 	{
-		UNUSED(render);
-		bgfx::setViewMode(render_pass.m_index, bgfx::ViewMode::DepthAscending);
-
 		render_pass.m_bgfx_state = MUD_GFX_STATE_DEFAULT;
 		render_pass.m_fbo = render.m_target->m_gbuffer.m_fbo;
 	}
@@ -97,9 +97,9 @@ namespace mud
 	};
 
 	template <class T_Filter>
-	vector<Item*> filter_cull(Scene& scene, T_Filter filter, bool nofilter = false)
+	frame_vector<Item*> filter_cull(Scene& scene, T_Filter filter, bool nofilter = false)
 	{
-		vector<Item*> culled;
+		frame_vector<Item*> culled;
 		scene.m_pool->pool<Item>().iterate([&](Item& item) {
 			if(nofilter || filter(item))
 			{
@@ -110,9 +110,9 @@ namespace mud
 	}
 
 	template <class T_Filter>
-	vector<Item*> frustum_cull(Scene& scene, const Plane6& frustum_planes, T_Filter filter, bool nofilter = false)
+	frame_vector<Item*> frustum_cull(Scene& scene, const Plane6& frustum_planes, T_Filter filter, bool nofilter = false)
 	{
-		vector<Item*> culled;
+		frame_vector<Item*> culled;
 		scene.m_pool->pool<Item>().iterate([&](Item& item) {
 			if(nofilter || filter(item))
 			{
@@ -123,7 +123,7 @@ namespace mud
 		return culled;
 	}
 
-	void cull_shadow_render(Render& render, vector<Item*>& result, const Plane6& planes)
+	void cull_shadow_render(Render& render, frame_vector<Item*>& result, const Plane6& planes)
 	{
 		auto filter = [](Item& item) { return item.m_visible && item.m_model->m_geometry[PLAIN] && (item.m_flags & ItemFlag::Shadows) != 0; };
 		result = filter_cull(render.m_scene, filter);
@@ -133,7 +133,7 @@ namespace mud
 			item->m_depth = distance(planes.m_near, item->m_aabb.m_center);
 	}
 
-	void cull_shadow_render(Render& render, vector<Item*>& result, const mat4& projection, const mat4& transform)
+	void cull_shadow_render(Render& render, frame_vector<Item*>& result, const mat4& projection, const mat4& transform)
 	{
 		Plane6 planes = frustum_planes(projection, transform);
 		cull_shadow_render(render, result, planes);
@@ -174,7 +174,7 @@ namespace mud
 		light_bounds.max.z = zmax;
 	}
 
-	void light_slice_cull(Render& render, Light& light, LightBounds& light_bounds, vector<Item*>& result)
+	void light_slice_cull(Render& render, Light& light, LightBounds& light_bounds, frame_vector<Item*>& result)
 	{
 		vec3 x = light.m_node.axis(X3);
 		vec3 y = light.m_node.axis(Y3);
@@ -3,6 +3,7 @@
 #pragma once
 
 #ifndef MUD_MODULES
+#include <infra/Arena.h>
 #include <math/Vec.hpp>
 #include <gfx/Renderer.h>
 #include <gfx/Frustum.h>
@@ -91,7 +92,8 @@ namespace mud
 			FrustumSlice m_frustum_slice;
 			LightBounds m_light_bounds;
 
-			vector<Item*> m_items;
+			// culled each frame, in frame memory
+			frame_vector<Item*> m_items;
 		};
 
 		vector<FrustumSlice> m_frustum_slices;
@@ -312,17 +312,19 @@ namespace mud
 		const mat4 world_to_clip = render.m_camera.m_projection * render.m_camera.m_transform;
 		const mat4 camera_to_world = inverse(render.m_camera.m_transform);
 
-		vector<Item*> items = render.m_shot->m_items;
-		render.m_shot->m_items.clear();
+		// visible items are packed in place at the front of the list
+		frame_vector<Item*>& items = render.m_shot->m_items;
+		size_t visible = 0;
 
 		Plane near = render.m_camera.near_plane();
 
-		vector<Item*> culled;
-		for(Item* item : items)
+		frame_vector<Item*> culled;
+		for(size_t i = 0; i < items.size(); ++i)
 		{
+			Item* item = items[i];
 			if((item->m_flags & ItemFlag::Occluder) != 0)
 			{
-				render.m_shot->m_items.push_back(item);
+				items[visible++] = item;
 				continue;
 			}
 
@@ -335,7 +337,7 @@ namespace mud
 
 			MaskedOcclusionCulling::CullingResult result = m_moc->TestRect(bounds.lo.x, bounds.lo.y, bounds.hi.x, bounds.hi.y, bounds.depth);
 			if(result == MaskedOcclusionCulling::VISIBLE)
-				render.m_shot->m_items.push_back(item);
+				items[visible++] = item;
 			else
 				culled.push_back(item);
 
@@ -348,6 +350,8 @@ namespace mud
 #endif
 		}
 
+		items.resize(visible);
+
 #ifdef DEBUG_CULLED
 		bool debug = render.m_target != nullptr;
 		if(debug)
@@ -22,7 +22,9 @@ namespace mud
 	PassDepth::PassDepth(GfxSystem& gfx_system, cstring name, BlockDepth& block_depth)
 		: DrawPass(gfx_system, name, PassType::Depth)
 		, m_block_depth(block_depth)
-	{}
+	{
+		m_draw_order = DrawOrder::FrontToBack;
+	}
 
 	PassDepth::PassDepth(GfxSystem& gfx_system, BlockDepth& block_depth)
 		: PassDepth(gfx_system, "depth", block_depth)
@@ -33,8 +35,6 @@ namespace mud
 		UNUSED(render);
 		render_pass.m_bgfx_state = 0 | BGFX_STATE_WRITE_Z | BGFX_STATE_DEPTH_TEST_LEQUAL | BGFX_STATE_CULL_CW ;
 
-		bgfx::setViewMode(render_pass.m_index, bgfx::ViewMode::DepthAscending);
-
 		m_block_depth.m_current_params = &m_block_depth.m_depth_params;
 	}
 
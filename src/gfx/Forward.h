@@ -25,6 +25,7 @@ namespace mud
     enum ShaderOption : unsigned int;
     enum class TextureSampler : unsigned int;
     enum class PassType : unsigned int;
+    enum class DrawOrder : unsigned int;
     enum class BlendMode : unsigned int;
     enum class CullMode : unsigned int;
     enum class DepthDraw : unsigned int;
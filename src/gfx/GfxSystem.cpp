@@ -16,8 +16,10 @@ module mud.gfx;
 #include <stl/string.h>
 #include <stl/map.h>
 #include <pool/ObjectPool.hpp>
+#include <infra/Arena.h>
 #include <infra/ToString.h>
 #include <infra/File.h>
+#include <jobs/JobSystem.h>
 #include <math/Image256.h>
 #include <gfx/Types.h>
 #include <gfx/GfxSystem.h>
@@ -224,8 +226,17 @@ namespace mud
 
 	void GfxSystem::begin_frame()
 	{
+		alloc_scope tag(alloc_tag::gfx);
+
+		// scratch memory of the previous frame is reclaimed, and its allocations closed
+		frame_arena().reset();
+		stl::next_alloc_frame();
+
 		RenderFrame frame = { m_frame, m_time, m_delta_time, Render::s_render_pass_id };
 
+		if(m_job_system)
+			m_job_system->tracer().frame();
+
 		{
 			ZoneScopedNC("programs", tracy::Color::Cyan);
 
@@ -243,6 +254,8 @@ namespace mud
 
 	bool GfxSystem::next_frame()
 	{
+		alloc_scope tag(alloc_tag::gfx);
+
 		RenderFrame frame = { m_frame, m_time, m_delta_time, Render::s_render_pass_id };
 
 #ifdef MUD_GFX_THREADED
@@ -6,6 +6,7 @@
 
 #ifndef MUD_MODULES
 #include <stl/vector.h>
+#include <stl/small_vector.h>
 #include <math/Vec.h>
 #include <math/Colour.h>
 #include <geom/Aabb.h>
@@ -69,9 +70,11 @@ namespace mud
 
 		vector<mat4> m_instances;
 
-		vector<bgfx::InstanceDataBuffer> m_instance_buffers;
+		// one per model item, and most models have one or two
+		small_vector<bgfx::InstanceDataBuffer, 2> m_instance_buffers;
 		
-		vector<Light*> m_lights;
+		// few lights touch an item besides the directional ones, so they are kept inline
+		small_vector<Light*, 4> m_lights;
 		//vector<ReflectionProbe*> m_reflection_probes;
 		//vector<GIProbe*> m_gi_probes;
 		
@@ -84,7 +84,10 @@ namespace mud
 		{
 			vec4 colour = to_vec4(block.m_colour.m_value);
 			encoder.setUniform(u_color, &colour);
+		}
 
+		void bind(bgfx::Encoder& encoder, const UnshadedMaterialBlock& block) const
+		{
 			encoder.setTexture(uint8_t(TextureSampler::Color), s_color, block.m_colour.m_texture ? block.m_colour.m_texture->m_texture : m_white_tex->m_texture);
 		}
 
@@ -110,7 +113,10 @@ namespace mud
 			vec4 params = { block.m_fresnel_bias, block.m_fresnel_scale, block.m_fresnel_power, 1.f };
 			encoder.setUniform(u_fresnel_value, &value);
 			encoder.setUniform(u_fresnel_params, &params);
+		}
 
+		void bind(bgfx::Encoder& encoder, const FresnelMaterialBlock& block) const
+		{
 			encoder.setTexture(uint8_t(TextureSampler::Color), s_fresnel, block.m_value.m_texture ? block.m_value.m_texture->m_texture : m_white_tex->m_texture);
 		}
 
@@ -160,7 +166,10 @@ namespace mud
 
 			vec4 pbr_channels = { float(block.m_roughness.m_channel), float(block.m_metallic.m_channel), 0.f, 0.f };
 			encoder.setUniform(u_pbr_channels_0, &pbr_channels);
+		}
 
+		void bind(bgfx::Encoder& encoder, const PbrMaterialBlock& block) const
+		{
 			auto is_valid = [](Texture* texture) { return texture != nullptr && bgfx::isValid(texture->m_texture); };
 
 			encoder.setTexture(uint8_t(TextureSampler::Color), s_albedo, is_valid(block.m_albedo.m_texture) ? block.m_albedo.m_texture->m_texture : m_white_tex->m_texture);
@@ -332,10 +341,8 @@ namespace mud
 			bgfx_state &= ~BGFX_STATE_WRITE_Z;
 	}
 
-	void Material::submit(bgfx::Encoder& encoder, uint64_t& bgfx_state, const Skin* skin) const
+	void Material::upload(bgfx::Encoder& encoder) const
 	{
-		this->state(bgfx_state);
-
 		s_base_material_uniform.upload(encoder, m_base_block);
 		if(m_unshaded_block.m_enabled)
 			s_unshaded_material_block.upload(encoder, m_unshaded_block);
@@ -343,8 +350,26 @@ namespace mud
 			s_fresnel_material_block.upload(encoder, m_fresnel_block);
 		if(m_pbr_block.m_enabled)
 			s_pbr_material_block.upload(encoder, m_pbr_block);
+	}
+
+	void Material::bind(bgfx::Encoder& encoder, uint64_t& bgfx_state, const Skin* skin) const
+	{
+		this->state(bgfx_state);
+
+		if(m_unshaded_block.m_enabled)
+			s_unshaded_material_block.bind(encoder, m_unshaded_block);
+		if(m_fresnel_block.m_enabled)
+			s_fresnel_material_block.bind(encoder, m_fresnel_block);
+		if(m_pbr_block.m_enabled)
+			s_pbr_material_block.bind(encoder, m_pbr_block);
 
 		if(skin)
 			encoder.setTexture(uint8_t(TextureSampler::Skeleton), s_base_material_uniform.s_skeleton, skin->m_texture);
 	}
+
+	void Material::submit(bgfx::Encoder& encoder, uint64_t& bgfx_state, const Skin* skin) const
+	{
+		this->upload(encoder);
+		this->bind(encoder, bgfx_state, skin);
+	}
 }
@@ -214,6 +214,9 @@ namespace mud
 		ShaderVersion shader_version(const Program& program) const;
 		ShaderVersion shader_version(const Program& program, const Item& item, const ModelItem& model_item) const;
 
+		// uniforms stay set on the following draws until changed, textures and state have to be bound for each draw
+		void upload(bgfx::Encoder& encoder) const;
+		void bind(bgfx::Encoder& encoder, uint64_t& bgfx_state, const Skin* skin = nullptr) const;
 		void submit(bgfx::Encoder& encoder, uint64_t& bgfx_state, const Skin* skin = nullptr) const;
 
 		static GfxSystem* ms_gfx_system;
@@ -13,6 +13,7 @@ module mud.gfx;
 #else
 #include <stl/string.h>
 #include <stl/algorithm.h>
+#include <infra/Sort.h>
 #include <pool/Pool.hpp>
 #include <math/Math.h>
 #include <math/Random.h>
@@ -202,13 +203,6 @@ namespace mud
 		++dest;
 	}
 
-	static int32_t particleSortFn(const void* _lhs, const void* _rhs)
-	{
-		const ParticleSort& lhs = *(const ParticleSort*)_lhs;
-		const ParticleSort& rhs = *(const ParticleSort*)_rhs;
-		return lhs.dist > rhs.dist ? -1 : 1;
-	}
-
 	ParticleSystem::ParticleSystem(GfxSystem& gfx_system, TPool<Flare>& emitters)
 		: m_gfx_system(gfx_system)
 		, m_block(*gfx_system.m_pipeline->block<BlockParticles>())
@@ -227,11 +221,11 @@ namespace mud
 	void ParticleSystem::update(float _dt)
 	{
 		uint32_t num_particles = 0;
-		for(Flare* emitter : m_emitters.m_vec_pool->m_objects)
+		m_emitters.iterate([&](Flare& emitter)
 		{
-			emitter->update(_dt);
-			num_particles += uint32_t(emitter->m_particles.size());
-		}
+			emitter.update(_dt);
+			num_particles += uint32_t(emitter.m_particles.size());
+		});
 		m_num = num_particles;
 	}
 
@@ -254,15 +248,26 @@ namespace mud
 
 			bgfx::allocTransientBuffers(&vertex_buffer, decl, max * 4, &index_buffer, max * 6);
 
-			vector<ParticleSort> particleSort{ max };
+			frame_vector<ParticleSort> particleSort{ max };
 
 			uint32_t pos = 0;
 			ParticleVertex* vertices = (ParticleVertex*)vertex_buffer.data;
 
-			for(Flare* emitter : m_emitters.m_vec_pool->m_objects)
-				pos += emitter->render(*m_block.m_sprites, view, eye, pos, max, particleSort.data(), vertices);
+			Flare* first = nullptr;
+			m_emitters.iterate([&](Flare& emitter)
+			{
+				first = first ? first : &emitter;
+				pos += emitter.render(*m_block.m_sprites, view, eye, pos, max, particleSort.data(), vertices);
+			});
+
+			// back to front : inverted keys put the largest distances first
+			frame_vector<uint32_t> depths(max);
+			frame_vector<uint32_t> temp_depths(max);
+			frame_vector<ParticleSort> temp_sort(max);
+			for(uint32_t ii = 0; ii < max; ++ii)
+				depths[ii] = ~float_key(particleSort[ii].dist);
 
-			qsort(particleSort.data(), max, sizeof(ParticleSort), particleSortFn);
+			radix_sort<uint32_t, ParticleSort>(depths, particleSort, temp_depths, temp_sort);
 
 			uint16_t* indices = (uint16_t*)index_buffer.data;
 			for(uint32_t ii = 0; ii < max; ++ii)
@@ -275,7 +280,7 @@ namespace mud
 			}
 
 			uint64_t bgfx_state = 0 | BGFX_STATE_WRITE_RGB | BGFX_STATE_WRITE_A | BGFX_STATE_DEPTH_TEST_LESS; // | BGFX_STATE_CULL_CW;
-			blend_state(m_emitters.m_vec_pool->m_objects[0]->m_blend_mode, bgfx_state);
+			blend_state(first->m_blend_mode, bgfx_state);
 
 			encoder.setState(bgfx_state);
 			encoder.setVertexBuffer(0, &vertex_buffer);
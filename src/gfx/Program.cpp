@@ -217,7 +217,7 @@ namespace mud
 	{
 		string m_name;
 
-		map<uint64_t, Version> m_versions;
+		hash_map<uint64_t, Version> m_versions;
 		vector<string> m_option_names;
 		vector<string> m_mode_names;
 
@@ -226,17 +226,32 @@ namespace mud
 
 	string program_defines(Program::Impl& program, const ShaderVersion& version)
 	{
-		string defines = "";
+		// appended in place : concatenating each define would allocate a temporary string for each piece
+		string defines;
+		defines.reserve(256);
 
 		for(size_t option = 0; option < 32; ++option)
 			if(version.m_options & uint32_t(1 << option))
-				defines += program.m_option_names[option] + ";";
+			{
+				defines += program.m_option_names[option];
+				defines += ";";
+			}
 
 		for(size_t mode = 0; mode < program.m_mode_names.size(); ++mode)
-			defines += program.m_mode_names[mode] + "=" + to_string(version.m_modes[mode]) + ";";
+		{
+			defines += program.m_mode_names[mode];
+			defines += "=";
+			defines += to_string(version.m_modes[mode]);
+			defines += ";";
+		}
 
 		for(const ShaderDefine& define : program.m_defines)
-			defines += string(define.m_name) + "=" + define.m_value + ";";
+		{
+			defines += define.m_name;
+			defines += "=";
+			defines += define.m_value;
+			defines += ";";
+		}
 
 		return defines;
 	}
@@ -177,6 +177,10 @@ namespace mud
 		render.m_frame.m_num_draw_calls += render.m_num_draw_calls;
 		render.m_frame.m_num_vertices += render.m_num_vertices;
 		render.m_frame.m_num_triangles += render.m_num_triangles;
+		render.m_frame.m_num_program_changes += render.m_num_program_changes;
+		render.m_frame.m_num_material_changes += render.m_num_material_changes;
+		render.m_frame.m_num_skipped_material_uploads += render.m_num_skipped_material_uploads;
+		render.m_frame.m_num_skipped_render_uploads += render.m_num_skipped_render_uploads;
 	}
 	
 	void Renderer::subrender(Render& render, Render& sub)
@@ -207,11 +211,6 @@ namespace mud
 
 	struct DrawList : public vector<DrawElement>
 	{
-		struct SortByKey
-		{
-			inline bool operator()(const DrawElement& a, const DrawElement& b) { return a.m_sort_key < b.m_sort_key; }
-		};
-
 		DrawList(size_t size)
 			: vector<DrawElement>(size)
 		{}
@@ -220,9 +219,32 @@ namespace mud
 
 		DrawElement* first() { return &(*this)[0]; }
 
-		DrawElement& add_element() { this->resize(this->size() + 1); return this->back(); }
+		// grows geometrically : the list is kept between frames, so it stops reallocating once large enough
+		DrawElement& add_element() { this->emplace_back(); return this->back(); }
+
+		// the keys are sorted with the indices of the elements, then each element is copied once to its place in m_sorted, which is swapped in
+		void sort()
+		{
+			const size_t count = this->size();
+			frame_vector<uint64_t> keys(count);
+			frame_vector<uint64_t> temp_keys(count);
+			frame_vector<uint32_t> indices(count);
+			frame_vector<uint32_t> temp_indices(count);
+			for(size_t i = 0; i < count; ++i)
+			{
+				keys[i] = (*this)[i].m_sort_key;
+				indices[i] = uint32_t(i);
+			}
+
+			radix_sort<uint64_t, uint32_t>(keys, indices, temp_keys, temp_indices);
+
+			m_sorted.clear();
+			for(uint32_t index : indices)
+				m_sorted.push_back((*this)[index]);
+			this->swap(m_sorted);
+		}
 
-		void sort() { quicksort<DrawElement>(*this, SortByKey()); }
+		vector<DrawElement> m_sorted;
 	};
 
 	struct DrawPass::Impl
@@ -230,6 +252,9 @@ namespace mud
 		Impl() : m_draw_elements(0) {}
 		DrawList m_draw_elements;
 		vector<DrawBlock*> m_draw_blocks;
+#ifdef MUD_GFX_JOBS
+		LoopGrain m_submit_grain = { 16 };
+#endif
 	};
 
 	DrawPass::DrawPass(GfxSystem& gfx_system, const char* name, PassType type)
@@ -251,6 +276,23 @@ namespace mud
 		m_draw_blocks = m_impl->m_draw_blocks;
 	}
 
+	// from the highest bits : program, material, mesh and depth, or depth first when drawn front to back or back to front
+	// the pass doesn't need to be in the key, since each pass sorts its own list
+	uint64_t draw_sort_key(const DrawElement& element, DrawOrder order)
+	{
+		const uint64_t program = element.m_bgfx_program.idx;
+		const uint64_t material = element.m_material->m_index;
+		const uint64_t mesh = element.m_model->m_mesh->m_index;
+		const uint64_t depth = float_key(element.m_item->m_depth) >> 16;
+
+		if(order == DrawOrder::FrontToBack)
+			return depth << 48 | program << 32 | material << 16 | mesh;
+		else if(order == DrawOrder::BackToFront)
+			return (~depth & 0xFFFF) << 48 | program << 32 | material << 16 | mesh;
+		else
+			return program << 48 | material << 32 | mesh << 16 | depth;
+	}
+
 	void DrawPass::add_element(Render& render, DrawElement element)
 	{
 		for(DrawBlock* block : m_impl->m_draw_blocks)
@@ -262,6 +304,7 @@ namespace mud
 		element.m_shader_version.set_option(0, QNORMALS, element.m_model->m_mesh->m_qnormals);
 
 		element.m_bgfx_program = const_cast<Program*>(element.m_program)->version(element.m_shader_version);
+		element.m_sort_key = draw_sort_key(element, m_draw_order);
 
 		m_impl->m_draw_elements.add_element() = element;
 	}
@@ -299,31 +342,10 @@ namespace mud
 				Skin* skin = (model_item.m_skin > -1 && item->m_rig) ? &item->m_rig->m_skins[model_item.m_skin] : nullptr;
 
 				DrawElement element = { *item, program, model_item, material, skin };
-				element.m_sort_key |= uint64_t(element.m_material->m_index) << 0;
-				element.m_sort_key |= uint64_t(element.m_model->m_mesh->m_index) << 16;
-
 				this->queue_draw_element(render, element);
 			}
 	}
 
-	uint32_t float_flip(uint32_t f)
-	{
-		uint32_t mask = -int(f >> 31) | 0x80000000;
-		return f ^ mask;
-	}
-
-	// Taking highest 10 bits for rough sort of floats.
-	// 0.01 maps to 752; 0.1 to 759; 1.0 to 766; 10.0 to 772;
-	// 100.0 to 779 etc. Negative numbers go similarly in 0..511 range.
-	uint32_t depth_to_bits(float depth)
-	{
-		union { float f; uint32_t i; } f2i;
-		f2i.f = depth;
-		f2i.i = float_flip(f2i.i); // flip bits to be sortable
-		uint32_t b = f2i.i >> 22; // take highest 10 bits
-		return b;
-	}
-
 	void DrawPass::submit_draw_elements(bgfx::Encoder& encoder, Render& render, Pass& pass, size_t first, size_t count) const
 	{
 		//printf("submit_draw_elements %i to %i\n", int(first), int(first + count));
@@ -331,22 +353,47 @@ namespace mud
 		Pass render_pass = pass;
 		render_pass.m_encoder = &encoder;
 
+		// uniforms stay set until changed, so they are only uploaded when they differ from the previous draw of the range
+		// the first draw of a range uploads them all, since the ranges can be submitted on different encoders
+		const Material* material = nullptr;
+		bgfx::ProgramHandle program = BGFX_INVALID_HANDLE;
+
 		for(size_t i = first; i < first + count; ++i)
 		{
 			const DrawElement& element = m_impl->m_draw_elements[i];
 
 			for(DrawBlock* block : m_impl->m_draw_blocks)
 				block->submit(render, element, render_pass);
-			
+
+			if(element.m_material != material)
+			{
+				element.m_material->upload(encoder);
+				material = element.m_material;
+				render.m_num_material_changes += 1;
+			}
+			else
+				render.m_num_skipped_material_uploads += 1;
+
+			if(i == first)
+				render.set_uniforms(encoder);
+			else
+				render.m_num_skipped_render_uploads += 1;
+
+			if(element.m_bgfx_program.idx != program.idx)
+			{
+				program = element.m_bgfx_program;
+				render.m_num_program_changes += 1;
+			}
+
 			uint64_t render_state = 0 | render_pass.m_bgfx_state | element.m_bgfx_state;
-			element.m_material->submit(encoder, render_state, element.m_skin);
+			element.m_material->bind(encoder, render_state, element.m_skin);
 			element.m_item->submit(encoder, render_state, *element.m_model);
 
-			render.set_uniforms(encoder);
-
 			encoder.setState(render_state);
 
-			encoder.submit(render_pass.m_index, element.m_bgfx_program, depth_to_bits(element.m_item->m_depth));
+			// the view sorts by depth first, so passing the index keeps the draws in the order of the list, even across encoders
+			// immediate draws of the pass are submitted at depth 0, so they come before all of them
+			encoder.submit(render_pass.m_index, element.m_bgfx_program, uint32_t(i + 1));
 
 			render.m_num_draw_calls += 1;
 			render.m_num_vertices += element.m_model->m_mesh->m_vertex_count;
@@ -360,6 +407,7 @@ namespace mud
 
 		m_impl->m_draw_elements.clear();
 		this->gather_draw_elements(render);
+		m_impl->m_draw_elements.sort();
 
 		uint8_t num_sub_passes = this->num_draw_passes(render);
 
@@ -376,6 +424,9 @@ namespace mud
 			this->next_draw_pass(render, render_pass);
 			render.m_viewport.render_pass(m_name, render_pass);
 
+			// the elements are already sorted : the view only has to keep them in order, see submit_draw_elements()
+			bgfx::setViewMode(render_pass.m_index, bgfx::ViewMode::DepthAscending);
+
 #ifdef MUD_GFX_JOBS
 			auto submit = [&](JobSystem& js, Job* job, size_t start, size_t count)
 			{
@@ -385,7 +436,9 @@ namespace mud
 			};
 
 			JobSystem& js = *m_gfx_system.m_job_system;
-			Job* job = split_jobs<16>(js, nullptr, 0, uint32_t(m_impl->m_draw_elements.size()), submit);
+			// skinned draws upload their bone matrices, so they weigh more than static ones
+			auto cost = [&](uint32_t i) { return m_impl->m_draw_elements[i].m_skin ? 4U : 1U; };
+			Job* job = split_jobs_adaptive(js, nullptr, 0, uint32_t(m_impl->m_draw_elements.size()), submit, m_impl->m_submit_grain, cost);
 			js.complete(job);
 #else
 			bgfx::Encoder& encoder = *render_pass.m_encoder;
@@ -129,6 +129,10 @@ namespace mud
 		uint32_t m_num_draw_calls = 0;
 		uint32_t m_num_vertices = 0;
 		uint32_t m_num_triangles = 0;
+		uint32_t m_num_program_changes = 0;
+		uint32_t m_num_material_changes = 0;
+		uint32_t m_num_skipped_material_uploads = 0;   // material uniforms not uploaded again, because the previous draw had the same material
+		uint32_t m_num_skipped_render_uploads = 0;     // render uniforms not uploaded again, because they were already set for the range
 	};
 
 	export_ struct MUD_GFX_EXPORT Render
@@ -169,6 +173,10 @@ namespace mud
 		uint32_t m_num_draw_calls = 0;
 		uint32_t m_num_vertices = 0;
 		uint32_t m_num_triangles = 0;
+		uint32_t m_num_program_changes = 0;
+		uint32_t m_num_material_changes = 0;
+		uint32_t m_num_skipped_material_uploads = 0;   // material uniforms not uploaded again, because the previous draw had the same material
+		uint32_t m_num_skipped_render_uploads = 0;     // render uniforms not uploaded again, because they were already set for the range
 
 		Pass next_pass(const char* name, bool subpass = false);
 		uint8_t next_pass_id() { return m_pass_index++; }
@@ -249,6 +257,14 @@ namespace mud
 		span<DrawBlock*> m_draw_blocks;
 	};
 	
+	// order of the elements of a draw pass : grouped by program, material and mesh, front to back for early depth rejection, or back to front for blending
+	export_ enum class DrawOrder : unsigned int
+	{
+		State,
+		FrontToBack,
+		BackToFront
+	};
+
 	export_ struct MUD_GFX_EXPORT DrawElement
 	{
 		DrawElement() {}
@@ -290,6 +306,8 @@ namespace mud
 		virtual void next_draw_pass(Render& render, Pass& render_pass) = 0;
 		virtual void queue_draw_element(Render& render, DrawElement& element) = 0;
 
+		DrawOrder m_draw_order = DrawOrder::State;
+
 		struct Impl;
 		unique<Impl> m_impl;
 	};
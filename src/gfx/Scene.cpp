@@ -92,7 +92,7 @@ namespace mud
 			}
 	}
 
-	void cull_items(Scene& scene, const Plane6& planes, vector<Item*>& items)
+	void cull_items(Scene& scene, const Plane6& planes, frame_vector<Item*>& items)
 	{
 		//items.reserve(m_pool->pool<Item>().size());
 		scene.m_pool->pool<Item>().iterate([&](Item& item)
@@ -105,7 +105,7 @@ namespace mud
 		});
 	}
 
-	void gather_items(Scene& scene, const Camera& camera, vector<Item*>& items)
+	void gather_items(Scene& scene, const Camera& camera, frame_vector<Item*>& items)
 	{
 		Plane6 planes = frustum_planes(camera.m_projection, camera.m_transform);
 
@@ -137,7 +137,7 @@ namespace mud
 		});
 	}
 
-	void gather_occluders(Scene& scene, const Camera& camera, vector<Item*>& occluders)
+	void gather_occluders(Scene& scene, const Camera& camera, frame_vector<Item*>& occluders)
 	{
 		Plane6 planes = frustum_planes(camera.m_projection, camera.m_transform);
 
@@ -152,7 +152,7 @@ namespace mud
 		});
 	}
 
-	void gather_lights(Scene& scene, vector<Light*>& lights)
+	void gather_lights(Scene& scene, frame_vector<Light*>& lights)
 	{
 		//lights.reserve(m_pool->pool<Light>().size());
 		scene.m_pool->pool<Light>().iterate([&](Light& light)
@@ -6,6 +6,7 @@
 
 #ifndef MUD_MODULES
 #include <type/Unique.h>
+#include <infra/Arena.h>
 #include <math/Vec.h>
 #endif
 #include <gfx/Forward.h>
@@ -106,11 +107,11 @@ namespace mud
 		vector<Sound*> m_orphan_sounds;
 	};
 
-	export_ MUD_GFX_EXPORT void cull_items(Scene& scene, const Plane6& planes, vector<Item*>& items);
+	export_ MUD_GFX_EXPORT void cull_items(Scene& scene, const Plane6& planes, frame_vector<Item*>& items);
 
-	export_ MUD_GFX_EXPORT void gather_items(Scene& scene, const Camera& camera, vector<Item*>& items);
-	export_ MUD_GFX_EXPORT void gather_occluders(Scene& scene, const Camera& camera, vector<Item*>& occluders);
-	export_ MUD_GFX_EXPORT void gather_lights(Scene& scene, vector<Light*>& lights);
+	export_ MUD_GFX_EXPORT void gather_items(Scene& scene, const Camera& camera, frame_vector<Item*>& items);
+	export_ MUD_GFX_EXPORT void gather_occluders(Scene& scene, const Camera& camera, frame_vector<Item*>& occluders);
+	export_ MUD_GFX_EXPORT void gather_lights(Scene& scene, frame_vector<Light*>& lights);
 
 	export_ MUD_GFX_EXPORT void gather_render(Scene& scene, Render& render);
 }
@@ -6,6 +6,7 @@
 
 #ifndef MUD_MODULES
 #include <stl/vector.h>
+#include <infra/Arena.h>
 #endif
 #include <gfx/Forward.h>
 
@@ -14,9 +15,10 @@ namespace mud
 	export_ class refl_ MUD_GFX_EXPORT Shot
 	{
 	public:
-		vector<Item*> m_items;
-		vector<Item*> m_occluders;
-		vector<Light*> m_lights;
+		// gathered each frame, in frame memory
+		frame_vector<Item*> m_items;
+		frame_vector<Item*> m_occluders;
+		frame_vector<Light*> m_lights;
 		vector<ReflectionProbe*> m_reflection_probes;
 		vector<GIProbe*> m_gi_probes;
 		vector<LightmapAtlas*> m_lightmaps;
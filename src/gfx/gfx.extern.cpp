@@ -4,8 +4,10 @@ module mud.gfx;
 #else
 #include <stl/array.h>
 #include <stl/vector.hpp>
+#include <stl/small_vector.hpp>
 #include <stl/unordered_map.hpp>
 #include <stl/unordered_set.hpp>
+#include <stl/flat_map.hpp>
 #include <gfx/Api.h>
 #endif
 
@@ -18,6 +20,7 @@ namespace stl
 	template class MUD_GFX_EXPORT vector<Animation*>;
 	template class MUD_GFX_EXPORT vector<Rig*>;
 	template class MUD_GFX_EXPORT vector<Light*>;
+	template class MUD_GFX_EXPORT small_vector<Light*, 4>;
 	template class MUD_GFX_EXPORT vector<Mesh*>;
 	template class MUD_GFX_EXPORT vector<Model*>;
 	template class MUD_GFX_EXPORT vector<Mime*>;
@@ -66,10 +69,15 @@ namespace stl
 	template class MUD_GFX_EXPORT vector<LightRecord>;
 	template class MUD_GFX_EXPORT vector<Froxelizer::FroxelEntry>;
 	template class MUD_GFX_EXPORT vector<array<uint, 8193>>;
-	template class MUD_GFX_EXPORT vector<unique<Gnode>>;
+	template class MUD_GFX_EXPORT small_vector<unique<Gnode>, 4>;
 	template class MUD_GFX_EXPORT vector<unique<RenderPass>>;
 	template class MUD_GFX_EXPORT vector<unique<GfxBlock>>;
 	template class MUD_GFX_EXPORT vector<unique<Picker>>;
+	template class MUD_GFX_EXPORT vector<Item*, FrameAllocator>;
+	template class MUD_GFX_EXPORT vector<Light*, FrameAllocator>;
+	template class MUD_GFX_EXPORT vector<ParticleSort, FrameAllocator>;
+	template class MUD_GFX_EXPORT vector<uint32_t, FrameAllocator>;
+	template class MUD_GFX_EXPORT vector<uint64_t, FrameAllocator>;
 	template class MUD_GFX_EXPORT unordered_map<int, Skeleton*>;
 	template class MUD_GFX_EXPORT unordered_map<string, Material*>;
 	template class MUD_GFX_EXPORT unordered_set<Model*>;
@@ -86,9 +94,14 @@ namespace stl
 	template class MUD_GFX_EXPORT unordered_map<string, unique<Flow>>;
 	template class MUD_GFX_EXPORT unordered_map<string, unique<Prefab>>;
 	template class MUD_GFX_EXPORT unordered_map<uint32_t, uint32_t>;
+#ifdef MUD_CHAINED_MAPS
 	template class MUD_GFX_EXPORT unordered_map<uint64_t, Program::Version>;
+#else
+	template class MUD_GFX_EXPORT flat_table<uint64_t, pair<uint64_t, Program::Version>>;
+	template class MUD_GFX_EXPORT flat_map<uint64_t, Program::Version>;
+#endif
 
-	template class MUD_GFX_EXPORT vector<bgfx::InstanceDataBuffer>;
+	template class MUD_GFX_EXPORT small_vector<bgfx::InstanceDataBuffer, 2>;
 	template class MUD_GFX_EXPORT unordered_map<uint, bgfx::VertexDecl>;
 }
 #endif
@@ -11,6 +11,7 @@
 module mud.infra;
 #else
 #include <infra/Arena.h>
+#include <infra/Thread.h>
 #endif
 
 namespace mud
@@ -52,4 +53,95 @@ namespace mud
 	AtomicFreeList::AtomicFreeList(void* begin, void* end, size_t elementSize, size_t alignment, size_t extra)
 		: m_head(init(begin, end, elementSize, alignment, extra))
 	{}
+
+	LinearArena::LinearArena(size_t block_size)
+		: m_block_size(block_size)
+	{}
+
+	LinearArena::~LinearArena()
+	{
+		while(m_blocks)
+		{
+			Block* next = m_blocks->m_next;
+			free(m_blocks);
+			m_blocks = next;
+		}
+	}
+
+	void LinearArena::use(Block* block)
+	{
+		m_current = reinterpret_cast<char*>(block + 1);
+		m_end = m_current + block->m_size;
+	}
+
+	void* LinearArena::grow(size_t size, size_t alignment)
+	{
+		const size_t block_size = size + alignment > m_block_size ? size + alignment : m_block_size;
+		Block* block = static_cast<Block*>(malloc(sizeof(Block) + block_size));
+		block->m_next = m_blocks;
+		block->m_size = block_size;
+		m_blocks = block;
+		m_heap_blocks++;
+
+		this->use(block);
+		char* const p = pointermath::align(m_current, alignment);
+		m_current = p + size;
+		return p;
+	}
+
+	void LinearArena::reset()
+	{
+		if(m_blocks && m_blocks->m_next)
+		{
+			size_t total = 0;
+			while(m_blocks)
+			{
+				Block* next = m_blocks->m_next;
+				total += m_blocks->m_size;
+				free(m_blocks);
+				m_blocks = next;
+			}
+
+			m_block_size = total;
+			Block* block = static_cast<Block*>(malloc(sizeof(Block) + total));
+			block->m_next = nullptr;
+			block->m_size = total;
+			m_blocks = block;
+			m_heap_blocks++;
+		}
+
+		if(m_blocks)
+			this->use(m_blocks);
+	}
+
+	FrameArena::FrameArena(size_t block_size)
+		: m_shared(block_size)
+	{
+		for(ThreadArena& thread : m_threads)
+			thread.m_arena.m_block_size = block_size;
+	}
+
+	void* FrameArena::alloc(size_t size, size_t alignment)
+	{
+		const uint32_t index = thread_index();
+		if(index < MAX_THREADS)
+			return m_threads[index].m_arena.alloc(size, alignment);
+
+		std::lock_guard<std::mutex> lock(m_shared_mutex);
+		return m_shared.alloc(size, alignment);
+	}
+
+	void FrameArena::reset()
+	{
+		for(ThreadArena& thread : m_threads)
+			thread.m_arena.reset();
+		m_shared.reset();
+		m_frame++;
+	}
+
+	FrameArena& frame_arena()
+	{
+		static FrameArena arena;
+		return arena;
+	}
 }
@@ -1,13 +1,16 @@
 #pragma once
 
+#include <infra/Forward.h>
 #include <stl/type_traits.h>
 #include <stl/stddef.h>
 #include <stl/span.h>
+#include <stl/vector.h>
 
 #include <cassert>
 #include <cstdlib>
 
 #include <atomic>
+#include <mutex>
 #include <utility>
 
 #if defined(WIN32)
@@ -101,8 +104,8 @@ namespace mud
 
 		void* pop()
 		{
-			Node* head = m_head.load(std::memory_order_relaxed);
-			while(head && !m_head.compare_exchange_weak(head, head->next, std::memory_order_release, std::memory_order_relaxed))
+			Node* head = m_head.load(std::memory_order_acquire);
+			while(head && !m_head.compare_exchange_weak(head, head->next, std::memory_order_acquire, std::memory_order_acquire))
 			{
 			}
 			return head;
@@ -118,10 +121,27 @@ namespace mud
 			}
 		}
 
+		// splices a chain of elements already linked from first to last, with a single exchange
+		void push(void* first, void* last)
+		{
+			assert(first && last);
+			Node* tail = static_cast<Node*>(last);
+			tail->next = m_head.load(std::memory_order_relaxed);
+			while(!m_head.compare_exchange_weak(tail->next, static_cast<Node*>(first), std::memory_order_release, std::memory_order_relaxed))
+			{
+			}
+		}
+
+		// takes the whole list : unlike pop(), it's safe against elements popped and pushed back concurrently (ABA)
+		void* pop_all()
+		{
+			return m_head.exchange(nullptr, std::memory_order_acquire);
+		}
+
 		void* current() { return m_head.load(std::memory_order_relaxed); }
 
 	private:
-		std::atomic<Node*> m_head;
+		std::atomic<Node*> m_head = { nullptr };
 	};
 
 #define GENERIC_MAX(a,b) ((a) > (b) ? (a) : (b))
@@ -194,4 +214,83 @@ namespace mud
 		void* m_end = nullptr;
 		T_FreeList m_freelist;
 	};
+
+	// bump allocator over a chain of blocks, all freed at once by reset()
+	// when a run needed more than one block, reset() replaces them with a single block large enough for all of them
+	export_ class MUD_INFRA_EXPORT LinearArena
+	{
+	public:
+		LinearArena(size_t block_size = 64 * 1024);
+		~LinearArena();
+
+		LinearArena(const LinearArena& other) = delete;
+		LinearArena& operator=(const LinearArena& other) = delete;
+
+		void* alloc(size_t size, size_t alignment = 16)
+		{
+			char* const p = pointermath::align(m_current, alignment);
+			if(p + size > m_end)
+				return this->grow(size, alignment);
+			m_current = p + size;
+			return p;
+		}
+
+		void reset();
+
+		struct Block
+		{
+			Block* m_next;
+			size_t m_size;
+		};
+
+		size_t m_block_size;
+		Block* m_blocks = nullptr;
+		char* m_current = nullptr;
+		char* m_end = nullptr;
+
+		// # of blocks allocated on the heap since creation
+		uint32_t m_heap_blocks = 0;
+
+	private:
+		void* grow(size_t size, size_t alignment);
+		void use(Block* block);
+	};
+
+	// scratch memory that lives until the start of the next frame
+	// each thread bumps from the arena of its thread_index(), so allocating takes no lock, and all arenas are reset at once
+	// threads past MAX_THREADS share an arena behind a lock
+	export_ class MUD_INFRA_EXPORT FrameArena
+	{
+	public:
+		static constexpr uint32_t MAX_THREADS = 64;
+
+		FrameArena(size_t block_size = 256 * 1024);
+
+		void* alloc(size_t size, size_t alignment = 16);
+
+		// no thread may allocate while the arenas are reset, and memory allocated before is invalid after
+		void reset();
+
+		struct alignas(64) ThreadArena
+		{
+			LinearArena m_arena;
+		};
+
+		ThreadArena m_threads[MAX_THREADS];
+		LinearArena m_shared;
+		std::mutex m_shared_mutex;
+		uint32_t m_frame = 0;
+	};
+
+	export_ MUD_INFRA_EXPORT FrameArena& frame_arena();
+
+	// allocator of stl containers that only live for the current frame : freeing is a no-op, the memory is reclaimed by FrameArena::reset()
+	export_ struct FrameAllocator
+	{
+		static void* static_allocate(size_t bytes) { return frame_arena().alloc(bytes); }
+		static void static_deallocate(void* ptr, size_t bytes) { UNUSED(ptr); UNUSED(bytes); }
+	};
+
+	export_ template <class T>
+	using frame_vector = vector<T, FrameAllocator>;
 }
@@ -27,8 +27,15 @@ module mud.infra;
 
 #if defined _WIN32
 #include <direct.h>
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#undef min
+#undef max
 #else
 #include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 namespace mud
@@ -40,6 +47,48 @@ namespace mud
 		dest_file << source_file.rdbuf();
 	}
 
+	MappedFile::MappedFile(const string& path)
+	{
+#if defined _WIN32
+		HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if(file == INVALID_HANDLE_VALUE)
+			return;
+		LARGE_INTEGER size;
+		HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0 ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+		CloseHandle(file);
+		if(!mapping)
+			return;
+		m_data = static_cast<uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		m_size = m_data ? size_t(size.QuadPart) : 0;
+		m_handle = mapping;
+#else
+		const int file = open(path.c_str(), O_RDONLY);
+		if(file < 0)
+			return;
+		struct stat info;
+		if(fstat(file, &info) == 0 && info.st_size > 0)
+		{
+			void* data = mmap(nullptr, size_t(info.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+			m_data = data != MAP_FAILED ? static_cast<uint8_t*>(data) : nullptr;
+			m_size = m_data ? size_t(info.st_size) : 0;
+		}
+		close(file);
+#endif
+	}
+
+	MappedFile::~MappedFile()
+	{
+#if defined _WIN32
+		if(m_data)
+			UnmapViewOfFile(m_data);
+		if(m_handle)
+			CloseHandle(m_handle);
+#else
+		if(m_data)
+			munmap(m_data, m_size);
+#endif
+	}
+
 	void write_file(const string& path, const string& content)
 	{
 		std::ofstream out(path.c_str());
@@ -34,6 +34,23 @@ namespace mud
 
 	export_ MUD_INFRA_EXPORT void copy_file(const string& source, const string& dest);
 
+	// read-only view of a whole file mapped in memory, empty if the file can't be opened
+	export_ class MUD_INFRA_EXPORT MappedFile
+	{
+	public:
+		MappedFile(const string& path);
+		~MappedFile();
+
+		MappedFile(const MappedFile& other) = delete;
+		MappedFile& operator=(const MappedFile& other) = delete;
+
+		span<uint8_t> data() const { return { m_data, m_size }; }
+
+		uint8_t* m_data = nullptr;
+		size_t m_size = 0;
+		void* m_handle = nullptr;
+	};
+
 	export_ MUD_INFRA_EXPORT string exec_path(int argc, char* argv[]);
 
 	export_ MUD_INFRA_EXPORT bool file_exists(const string& path);
@@ -24,6 +24,7 @@ namespace mud
 	using stl::span;
 
     struct Filepath;
+    class MappedFile;
     struct swallow;
     class NonCopy;
     class Movabl;
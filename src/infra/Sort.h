@@ -8,6 +8,9 @@
 #include <infra/Config.h>
 #include <stl/span.h>
 
+#include <stdint.h>
+#include <string.h>
+
 namespace mud
 {
 #if 0
@@ -76,9 +79,9 @@ namespace mud
 		{
 			using stl::swap;
 			const size_t mid = left + (right - left) / 2;
-			const T& pivot = vec[mid];
 			// move the mid point value to the front.
 			swap(vec[mid], vec[left]);
+			const T& pivot = vec[left];
 			size_t i = left + 1;
 			size_t j = right;
 			while(i <= j)
@@ -118,4 +121,105 @@ namespace mud
 		if(values.size() > 0)
 			quicksort(values, greater, 0, values.size() - 1);
 	}
+
+	// flips the bits of a float so that, read as an unsigned integer, it sorts like the float did
+	export_ inline uint32_t float_flip(uint32_t f)
+	{
+		uint32_t mask = -int32_t(f >> 31) | 0x80000000;
+		return f ^ mask;
+	}
+
+	export_ inline uint32_t float_key(float f)
+	{
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(float));
+		return float_flip(bits);
+	}
+
+	// below this count, an insertion sort is faster than the radix passes
+	constexpr size_t RADIX_SORT_MIN = 64;
+
+	template <class T_Key, class T_Value>
+	void insertion_sort(span<T_Key> keys, span<T_Value> values)
+	{
+		for(size_t i = 1; i < keys.size(); ++i)
+		{
+			const T_Key key = keys[i];
+			T_Value value = values[i];
+			size_t j = i;
+			for(; j > 0 && key < keys[j - 1]; --j)
+			{
+				keys[j] = keys[j - 1];
+				values[j] = values[j - 1];
+			}
+			keys[j] = key;
+			values[j] = value;
+		}
+	}
+
+	// stable sort of unsigned 32 or 64 bit keys in ascending order, each value moving with its key : sort floats with float_key(), and reverse with ~key
+	// one pass per byte of the key, from the least significant, that moves the elements into the temp spans and back : the passes of bytes that all the keys share are skipped
+	// values are moved once per pass, so large elements are better sorted as indices
+	// parallel_radix_sort() in jobs/JobLoop.hpp splits the passes over the job system
+	template <class T_Key, class T_Value>
+	void radix_sort(span<T_Key> keys, span<T_Value> values, span<T_Key> temp_keys, span<T_Value> temp_values)
+	{
+		static_assert(sizeof(T_Key) == 4 || sizeof(T_Key) == 8, "radix_sort only sorts 32 and 64 bit keys");
+		constexpr size_t digits = sizeof(T_Key);
+
+		const size_t count = keys.size();
+		if(count < RADIX_SORT_MIN)
+		{
+			insertion_sort(keys, values);
+			return;
+		}
+
+		// the histograms of all digits are gathered in a single read of the keys
+		uint32_t histograms[digits][256] = {};
+		for(size_t i = 0; i < count; ++i)
+		{
+			const T_Key key = keys[i];
+			for(size_t d = 0; d < digits; ++d)
+				histograms[d][(key >> (d * 8)) & 0xFF]++;
+		}
+
+		T_Key* from_keys = keys.data();
+		T_Value* from_values = values.data();
+		T_Key* to_keys = temp_keys.data();
+		T_Value* to_values = temp_values.data();
+
+		for(size_t d = 0; d < digits; ++d)
+		{
+			uint32_t* histogram = histograms[d];
+			if(histogram[(from_keys[0] >> (d * 8)) & 0xFF] == count)
+				continue;
+
+			uint32_t offsets[256];
+			uint32_t offset = 0;
+			for(size_t b = 0; b < 256; ++b)
+			{
+				offsets[b] = offset;
+				offset += histogram[b];
+			}
+
+			for(size_t i = 0; i < count; ++i)
+			{
+				const uint32_t at = offsets[(from_keys[i] >> (d * 8)) & 0xFF]++;
+				to_keys[at] = from_keys[i];
+				to_values[at] = from_values[i];
+			}
+
+			using stl::swap;
+			swap(from_keys, to_keys);
+			swap(from_values, to_values);
+		}
+
+		// after an odd number of passes, the sorted elements are in the temp spans
+		if(from_keys != keys.data())
+			for(size_t i = 0; i < count; ++i)
+			{
+				keys[i] = from_keys[i];
+				values[i] = from_values[i];
+			}
+	}
 }
@@ -27,16 +27,44 @@
 #    define gettid() syscall(SYS_gettid)
 #endif
 
+#if defined(__linux__)
+#    include <linux/futex.h>
+#    include <cstdio>
+#elif defined(__APPLE__)
+#    include <sys/sysctl.h>
+#endif
+
 #ifdef WIN32
 //#include <Windows.h>
 //#include <tchar.h>*
 //#undef small
 #endif
 
+#if defined(_WIN32)
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#    undef min
+#    undef max
+#    ifdef _MSC_VER
+#        pragma comment(lib, "synchronization.lib")
+#    endif
+#    define MUD_FUTEX_WAIT_ON_ADDRESS
+#elif !defined(__linux__)
+#    include <mutex>
+#    include <condition_variable>
+#    define MUD_FUTEX_BUCKETS
+#endif
+
+#include <thread>
+#include <mutex>
+
 
 #ifdef MUD_MODULES
 module mud.infra;
 #else
+#include <stl/vector.hpp>
+#include <stl/math.h>
+#include <stl/bitset.h>
 #include <infra/Config.h>
 #include <infra/Thread.h>
 #endif
@@ -95,4 +123,187 @@ namespace mud
 		//SetThreadAffinityMask(GetCurrentThread(), mask);
 #endif
 	}
+
+	void set_thread_cpu(uint32_t cpu)
+	{
+#if defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		CPU_SET(cpu, &set);
+		sched_setaffinity(gettid(), sizeof(set), &set);
+#elif defined(_WIN32)
+		SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+#else
+		UNUSED(cpu);
+#endif
+	}
+
+#if defined(__linux__)
+	static bool read_first_cpu(const char* path, uint32_t& cpu)
+	{
+		FILE* file = fopen(path, "r");
+		if(!file)
+			return false;
+		const bool read = fscanf(file, "%u", &cpu) == 1;
+		fclose(file);
+		return read;
+	}
+#endif
+
+	CpuTopology cpu_topology()
+	{
+		CpuTopology topology;
+		topology.m_logical = max(std::thread::hardware_concurrency(), 1U);
+
+		// leader of each logical cpu, i.e. the first logical cpu of the same physical core
+		vector<uint32_t> leaders(topology.m_logical);
+		for(uint32_t cpu = 0; cpu < topology.m_logical; ++cpu)
+			leaders[cpu] = cpu;
+
+#if defined(__linux__)
+		for(uint32_t cpu = 0; cpu < topology.m_logical; ++cpu)
+		{
+			char path[128];
+			snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/topology/thread_siblings_list", cpu);
+			uint32_t leader;
+			if(read_first_cpu(path, leader) && leader < topology.m_logical)
+				leaders[cpu] = leader;
+		}
+#elif defined(_WIN32)
+		DWORD size = 0;
+		GetLogicalProcessorInformation(nullptr, &size);
+		vector<SYSTEM_LOGICAL_PROCESSOR_INFORMATION> infos(size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION));
+		if(!infos.empty() && GetLogicalProcessorInformation(infos.data(), &size))
+			for(const SYSTEM_LOGICAL_PROCESSOR_INFORMATION& info : infos)
+			{
+				if(info.Relationship != RelationProcessorCore || !info.ProcessorMask)
+					continue;
+				uint32_t leader = uint32_t(stl::ctz(uint64_t(info.ProcessorMask)));
+				for(uint32_t cpu = leader; cpu < topology.m_logical && cpu < 64; ++cpu)
+					if(info.ProcessorMask & (ULONG_PTR(1) << cpu))
+						leaders[cpu] = leader;
+			}
+#elif defined(__APPLE__)
+		int physical = 0;
+		size_t length = sizeof(physical);
+		if(sysctlbyname("hw.physicalcpu", &physical, &length, nullptr, 0) == 0 && physical > 0)
+		{
+			// macOS doesn't expose which cpus are siblings, assume they are interleaved
+			const uint32_t smt = topology.m_logical / uint32_t(physical);
+			for(uint32_t cpu = 0; cpu < topology.m_logical && smt > 1; ++cpu)
+				leaders[cpu] = cpu - cpu % smt;
+		}
+#endif
+
+		for(uint32_t cpu = 0; cpu < topology.m_logical; ++cpu)
+			if(leaders[cpu] == cpu)
+				topology.m_cpus.push_back(cpu);
+		topology.m_physical = uint32_t(topology.m_cpus.size());
+		for(uint32_t cpu = 0; cpu < topology.m_logical; ++cpu)
+			if(leaders[cpu] != cpu)
+				topology.m_cpus.push_back(cpu);
+		return topology;
+	}
+
+#if defined(MUD_FUTEX_BUCKETS)
+	struct FutexBucket
+	{
+		std::mutex m_lock;
+		std::condition_variable m_condition;
+	};
+
+	static FutexBucket& futex_bucket(std::atomic<uint32_t>& value)
+	{
+		static FutexBucket buckets[64];
+		return buckets[(uintptr_t(&value) / sizeof(value)) % 64];
+	}
+#endif
+
+	void futex_wait(std::atomic<uint32_t>& value, uint32_t expected)
+	{
+#if defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#elif defined(MUD_FUTEX_WAIT_ON_ADDRESS)
+		WaitOnAddress(&value, &expected, sizeof(expected), INFINITE);
+#else
+		FutexBucket& bucket = futex_bucket(value);
+		std::unique_lock<std::mutex> lock(bucket.m_lock);
+		if(value.load(std::memory_order_relaxed) == expected)
+			bucket.m_condition.wait(lock);
+#endif
+	}
+
+	void futex_wake_one(std::atomic<uint32_t>& value)
+	{
+#if defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(MUD_FUTEX_WAIT_ON_ADDRESS)
+		WakeByAddressSingle(&value);
+#else
+		// buckets are shared between addresses, so every waiter has to recheck its own value
+		FutexBucket& bucket = futex_bucket(value);
+		{ std::lock_guard<std::mutex> lock(bucket.m_lock); }
+		bucket.m_condition.notify_all();
+#endif
+	}
+
+	void futex_wake_all(std::atomic<uint32_t>& value)
+	{
+#if defined(__linux__)
+		syscall(SYS_futex, reinterpret_cast<uint32_t*>(&value), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#elif defined(MUD_FUTEX_WAIT_ON_ADDRESS)
+		WakeByAddressAll(&value);
+#else
+		FutexBucket& bucket = futex_bucket(value);
+		{ std::lock_guard<std::mutex> lock(bucket.m_lock); }
+		bucket.m_condition.notify_all();
+#endif
+	}
+
+	namespace
+	{
+		struct ThreadIndices
+		{
+			std::mutex m_mutex;
+			vector<uint32_t> m_available;
+			uint32_t m_next = 0;
+		};
+
+		ThreadIndices& thread_indices()
+		{
+			static ThreadIndices indices;
+			return indices;
+		}
+
+		struct ThreadIndex
+		{
+			ThreadIndex()
+			{
+				ThreadIndices& indices = thread_indices();
+				std::lock_guard<std::mutex> lock(indices.m_mutex);
+				if(indices.m_available.empty())
+					m_index = indices.m_next++;
+				else
+				{
+					m_index = indices.m_available.back();
+					indices.m_available.pop_back();
+				}
+			}
+
+			~ThreadIndex()
+			{
+				ThreadIndices& indices = thread_indices();
+				std::lock_guard<std::mutex> lock(indices.m_mutex);
+				indices.m_available.push_back(m_index);
+			}
+
+			uint32_t m_index;
+		};
+	}
+
+	uint32_t thread_index()
+	{
+		thread_local ThreadIndex index;
+		return index.m_index;
+	}
 }
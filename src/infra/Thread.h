@@ -3,8 +3,11 @@
 #include <infra/Forward.h>
 
 #include <stl/stddef.h>
+#include <stl/vector.h>
 #include <stdint.h>
 
+#include <atomic>
+
 namespace mud
 {
 	export_ MUD_INFRA_EXPORT void set_thread_name(const char* name);
@@ -18,4 +21,22 @@ namespace mud
 
 	export_ MUD_INFRA_EXPORT void set_thread_priority(ThreadPriority priority);
 	export_ MUD_INFRA_EXPORT void set_thread_affinity(uint32_t mask);
+	export_ MUD_INFRA_EXPORT void set_thread_cpu(uint32_t cpu);
+
+	// small index of the calling thread, for per-thread data kept in arrays : the index of a thread that exits is given to the next one
+	export_ MUD_INFRA_EXPORT uint32_t thread_index();
+
+	export_ struct MUD_INFRA_EXPORT CpuTopology
+	{
+		uint32_t m_logical = 0;       // # of hardware threads
+		uint32_t m_physical = 0;      // # of physical cores
+		vector<uint32_t> m_cpus;      // logical cpus, ordered so that each physical core appears once before any SMT sibling
+	};
+
+	export_ MUD_INFRA_EXPORT CpuTopology cpu_topology();
+
+	// blocks the calling thread as long as value == expected, or until woken : spurious wake-ups are possible
+	export_ MUD_INFRA_EXPORT void futex_wait(std::atomic<uint32_t>& value, uint32_t expected);
+	export_ MUD_INFRA_EXPORT void futex_wake_one(std::atomic<uint32_t>& value);
+	export_ MUD_INFRA_EXPORT void futex_wake_all(std::atomic<uint32_t>& value);
 }
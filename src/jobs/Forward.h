@@ -9,5 +9,7 @@
 
 namespace mud
 {
+	struct Job;
 	class JobSystem;
+	class JobTracer;
 }
@@ -16,9 +16,9 @@ namespace mud
 		Job(Job&&) = delete;
 
 		JobFunc function;
-		uint16_t parent;
-		std::atomic<uint16_t> running_jobs = { 0 };
-		JobStorage storage; // on 64-bits systems, there is an extra 32-bits lost here
+		uint32_t parent;
+		std::atomic<uint32_t> running_jobs = { 0 };
+		JobStorage storage;
 	};
 
 	template <class T>
@@ -1,8 +1,12 @@
 #pragma once
 
 #include <stl/span.h>
+#include <stl/vector.h>
+#include <infra/AlignedAlloc.h>
 #include <jobs/Job.h>
 
+#include <cstring>
+
 namespace mud
 {
 	namespace details
@@ -32,40 +36,48 @@ namespace mud
 					return;
 				}
 
-				if(m_splitter.split(m_splits, m_count))
+				if(m_splitter.split(m_splits, m_start, m_count))
 				{
-					const uint32_t lc = m_count / 2;
+					const uint32_t lc = m_splitter.left(m_start, m_count);
 					Jobs ld(m_start, lc, m_splits + uint8_t(1), m_functor, m_splitter);
 					Job* left = js.job(parent, ld);
-
-					js.run(left);
+					if(left)
+						js.run(left);
+					else
+						ld.run(js, parent);
 
 					const uint32_t rc = m_count - lc;
 					Jobs rd(m_start + lc, rc, m_splits + uint8_t(1), m_functor, m_splitter);
 					Job* right = js.job(parent, rd);
-
-					js.run(right, JobSystem::DONT_SIGNAL);
+					if(right)
+						js.run(right, JobSystem::DONT_SIGNAL);
+					else
+						rd.run(js, parent);
 				}
 				else
 				{
+					const uint64_t begin = m_splitter.clock();
 					m_functor(js, parent, m_start, m_count);
+					m_splitter.measure(m_start, m_count, begin);
 				}
 			}
 
 			void parallel(JobSystem& js, Job* parent, uint32_t start, uint32_t count, uint8_t splits)
 			{
 				//auto round_to = [](uint32_t number, uint32_t divisor) { return number - number % divisor + divisor * !!(number % divisor); };
-				if(m_splitter.split(splits, count))
+				if(m_splitter.split(splits, start, count))
 				{
 					//const uint32_t left = round_to(count / 2, 64);
-					const uint32_t left = count / 2;
+					const uint32_t left = m_splitter.left(start, count);
 					parallel(js, parent, start, left, splits);
 					parallel(js, parent, start + left, count - left, splits + 1);
 				}
 				else
 				{
-					Job* job = js.job(parent, [f = m_functor, start, count](JobSystem& js, Job* job) {
+					Job* job = js.job(parent, [f = m_functor, s = m_splitter, start, count](JobSystem& js, Job* job) {
+						const uint64_t begin = s.clock();
 						f(js, job, start, count);
+						s.measure(start, count, begin);
 					});
 					if(job)
 						js.run(job);
@@ -110,11 +122,107 @@ namespace mud
 		return split_jobs(js, parent, slice.data(), slice.size(), functor, splitter);
 	}
 
+	// a splitter decides whether a range is split in two and where, and is given the duration of the leaf ranges it produced
 	template <uint32_t Count, uint32_t MaxSplits = 12>
 	class CountSplitter
 	{
 	public:
-		bool split(uint32_t splits, uint32_t count) const { return (splits < MaxSplits && count >= Count * 2); }
+		bool split(uint32_t splits, uint32_t start, uint32_t count) const { UNUSED(start); return (splits < MaxSplits && count >= Count * 2); }
+		uint32_t left(uint32_t start, uint32_t count) const { UNUSED(start); return count / 2; }
+		uint64_t clock() const { return 0; }
+		void measure(uint32_t start, uint32_t count, uint64_t begin) const { UNUSED(start); UNUSED(count); UNUSED(begin); }
+	};
+
+	// granularity of one parallel loop, kept by the caller across frames : the duration of each leaf range is measured,
+	// and update() retunes the grain so that leaves last about m_target, one grain per loop, which can't run concurrently with itself
+	export_ struct LoopGrain
+	{
+		LoopGrain(uint32_t grain = 64, uint64_t target = 50000) : m_grain(grain), m_target(target) {}
+
+		uint32_t m_grain;                        // ranges of less than two grains are not split, in elements or cost units
+		uint64_t m_target;                       // target duration of a leaf range, in nanoseconds
+		uint32_t m_min_grain = 1;
+		uint32_t m_max_grain = 1 << 20;
+
+		std::atomic<uint64_t> m_time = { 0 };   // total duration of the leaves measured since the last update
+		std::atomic<uint64_t> m_units = { 0 };  // total elements or cost units of the leaves measured since the last update
+
+		// prefix sum of the element costs, when a cost callback is given
+		uint32_t m_start = 0;
+		vector<uint64_t> m_costs;
+
+		void update()
+		{
+			const uint64_t time = m_time.exchange(0, std::memory_order_relaxed);
+			const uint64_t units = m_units.exchange(0, std::memory_order_relaxed);
+			if(time == 0 || units == 0)
+				return;
+
+			// halfway to the measured ideal grain, so that one noisy frame doesn't throw it off
+			const double ideal = double(m_target) * double(units) / double(time);
+			const double grain = (double(m_grain) + ideal) * 0.5;
+			m_grain = grain < double(m_min_grain) ? m_min_grain : grain > double(m_max_grain) ? m_max_grain : uint32_t(grain);
+		}
+
+		template <class C>
+		void costs(uint32_t start, uint32_t count, C cost)
+		{
+			m_start = start;
+			m_costs.resize(count + 1);
+			m_costs[0] = 0;
+			for(uint32_t i = 0; i < count; ++i)
+				m_costs[i + 1] = m_costs[i] + cost(start + i);
+		}
+
+		uint64_t units(uint32_t start, uint32_t count) const
+		{
+			if(m_costs.empty())
+				return count;
+			return m_costs[start - m_start + count] - m_costs[start - m_start];
+		}
+	};
+
+	// splits ranges in halves of equal cost down to the grain, which is adjusted between frames from the measured leaf durations
+	template <uint32_t MaxSplits = 12>
+	class AdaptiveSplitter
+	{
+	public:
+		AdaptiveSplitter(LoopGrain& grain) : m_grain(&grain) {}
+
+		bool split(uint32_t splits, uint32_t start, uint32_t count) const
+		{
+			return splits < MaxSplits && count >= 2 && m_grain->units(start, count) >= uint64_t(m_grain->m_grain) * 2;
+		}
+
+		uint32_t left(uint32_t start, uint32_t count) const
+		{
+			if(m_grain->m_costs.empty())
+				return count / 2;
+
+			// first element at which the cost prefix reaches the middle of the range cost
+			const uint64_t* costs = m_grain->m_costs.data() + (start - m_grain->m_start);
+			const uint64_t half = costs[0] + (costs[count] - costs[0]) / 2;
+			uint32_t lo = 1, hi = count - 1;
+			while(lo < hi)
+			{
+				const uint32_t mid = (lo + hi) / 2;
+				if(costs[mid] < half)
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			return lo;
+		}
+
+		uint64_t clock() const { return JobTracer::now(); }
+
+		void measure(uint32_t start, uint32_t count, uint64_t begin) const
+		{
+			m_grain->m_time.fetch_add(JobTracer::now() - begin, std::memory_order_relaxed);
+			m_grain->m_units.fetch_add(m_grain->units(start, count), std::memory_order_relaxed);
+		}
+
+		LoopGrain* m_grain;
 	};
 
 	template <uint32_t Count, class F>
@@ -129,6 +237,24 @@ namespace mud
 		return split_jobs(js, parent, slice.data(), slice.size(), functor, CountSplitter<Count>());
 	}
 
+	// the grain is first updated from the leaves measured during the previous call with the same LoopGrain
+	template <class F>
+	Job* split_jobs_adaptive(JobSystem& js, Job* parent, uint32_t start, uint32_t count, F functor, LoopGrain& grain)
+	{
+		grain.update();
+		grain.m_costs.clear();
+		return split_jobs(js, parent, start, count, functor, AdaptiveSplitter<>(grain));
+	}
+
+	// cost(uint32_t index) returns the relative cost of each element, ranges are then balanced on cost rather than count
+	template <class F, class C>
+	Job* split_jobs_adaptive(JobSystem& js, Job* parent, uint32_t start, uint32_t count, F functor, LoopGrain& grain, C cost)
+	{
+		grain.update();
+		grain.costs(start, count, cost);
+		return split_jobs(js, parent, start, count, functor, AdaptiveSplitter<>(grain));
+	}
+
 	template <uint32_t Count, class F>
 	Job* parallel_jobs(JobSystem& js, Job* parent, uint32_t start, uint32_t count, F functor)
 	{
@@ -169,4 +295,316 @@ namespace mud
 		Job* job = split_jobs<Count>(js, parent, 0, count, copy);
 		js.complete(job);
 	}
+
+	namespace details
+	{
+		// partial results are each on their own cache line, so that jobs accumulating side by side don't false share
+		template <class T>
+		struct alignas(CACHELINE_SIZE) Padded
+		{
+			T m_value;
+		};
+
+#ifndef USE_STL
+		template <class T>
+		using padded_vector = vector<Padded<T>, TinystlAlignedAllocator<Padded<T>>>;
+#else
+		template <class T>
+		using padded_vector = vector<Padded<T>, STLAlignedAllocator<Padded<T>>>;
+#endif
+
+		// ranges are cut in a fixed number of chunks, one partial result each, so that results don't depend on scheduling
+		constexpr uint32_t MAX_CHUNKS = 256;
+
+		inline uint32_t chunk_count(uint32_t count, uint32_t granularity)
+		{
+			const uint32_t chunks = count / granularity;
+			return chunks < 1 ? 1 : chunks > MAX_CHUNKS ? MAX_CHUNKS : chunks;
+		}
+
+		inline uint32_t chunk_begin(uint32_t chunk, uint32_t chunks, uint32_t count)
+		{
+			return uint32_t(uint64_t(count) * chunk / chunks);
+		}
+
+		template <class F>
+		void for_chunks(JobSystem& js, Job* parent, uint32_t chunks, F functor)
+		{
+			Job* job = parallel_jobs<1>(js, parent, 0, chunks, [&](JobSystem&, Job*, uint32_t chunk) { functor(chunk); });
+			js.complete(job);
+		}
+
+		// finds how many elements of left come before the output position diagonal when merging left and right
+		template <class T, class Pred>
+		uint32_t merge_path(const T* left, uint32_t lc, const T* right, uint32_t rc, uint32_t diagonal, Pred greater)
+		{
+			uint32_t lo = diagonal > rc ? diagonal - rc : 0;
+			uint32_t hi = diagonal < lc ? diagonal : lc;
+			while(lo < hi)
+			{
+				const uint32_t mid = (lo + hi) / 2;
+				if(!greater(left[mid], right[diagonal - mid - 1]))
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			return lo;
+		}
+
+		// writes the first count elements of the stable merge of left and right to out
+		template <class T, class Pred>
+		void merge(const T* left, uint32_t lc, const T* right, uint32_t rc, T* out, uint32_t count, Pred greater)
+		{
+			uint32_t l = 0, r = 0;
+			for(uint32_t i = 0; i < count; ++i)
+			{
+				if(r >= rc || (l < lc && !greater(left[l], right[r])))
+					out[i] = left[l++];
+				else
+					out[i] = right[r++];
+			}
+		}
+
+		// serial stable sort : insertion sort of runs of 16, then bottom-up merges ping-ponging with scratch
+		template <class T, class Pred>
+		void merge_sort(T* data, T* scratch, uint32_t count, Pred greater)
+		{
+			constexpr uint32_t run = 16;
+			for(uint32_t begin = 0; begin < count; begin += run)
+			{
+				const uint32_t end = begin + run < count ? begin + run : count;
+				for(uint32_t i = begin + 1; i < end; ++i)
+				{
+					T value = move(data[i]);
+					uint32_t j = i;
+					for(; j > begin && greater(data[j - 1], value); --j)
+						data[j] = move(data[j - 1]);
+					data[j] = move(value);
+				}
+			}
+
+			T* source = data;
+			T* dest = scratch;
+			for(uint32_t width = run; width < count; width *= 2)
+			{
+				for(uint32_t first = 0; first < count; first += width * 2)
+				{
+					const uint32_t middle = first + width < count ? first + width : count;
+					const uint32_t last = first + width * 2 < count ? first + width * 2 : count;
+					merge(source + first, middle - first, source + middle, last - middle, dest + first, last - first, greater);
+				}
+				swap(source, dest);
+			}
+
+			if(source != data)
+				for(uint32_t i = 0; i < count; ++i)
+					data[i] = move(source[i]);
+		}
+	}
+
+	// reduces [start, start + count) : functor(T& partial, uint32_t index) accumulates into a chunk partial result,
+	// and partial results are then combined in order with reduce(const T&, const T&)
+	template <uint32_t Count, class T, class F, class R>
+	T parallel_reduce(JobSystem& js, Job* parent, uint32_t start, uint32_t count, T identity, F functor, R reduce)
+	{
+		if(count == 0)
+			return identity;
+
+		const uint32_t chunks = details::chunk_count(count, Count);
+		details::padded_vector<T> partials(chunks);
+
+		details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+		{
+			T partial = identity;
+			const uint32_t end = start + details::chunk_begin(chunk + 1, chunks, count);
+			for(uint32_t i = start + details::chunk_begin(chunk, chunks, count); i < end; ++i)
+				functor(partial, i);
+			partials[chunk].m_value = partial;
+		});
+
+		T result = identity;
+		for(uint32_t i = 0; i < chunks; ++i)
+			result = reduce(result, partials[i].m_value);
+		return result;
+	}
+
+	template <uint32_t Count, class T, class U, class F, class R>
+	U parallel_reduce(JobSystem& js, Job* parent, span<T> data, U identity, F functor, R reduce)
+	{
+		T* elements = data.data();
+		auto user = [elements, &functor](U& partial, uint32_t i) { functor(partial, elements[i]); };
+		return parallel_reduce<Count>(js, parent, 0, uint32_t(data.size()), identity, user, reduce);
+	}
+
+	// prefix sum of input into output with the associative op, input and output can be the same span
+	// an exclusive scan writes identity to output[0] and the combination of all preceding elements after that
+	template <uint32_t Count, class T, class Op>
+	void parallel_scan(JobSystem& js, Job* parent, span<T> input, span<T> output, T identity, Op op, bool inclusive = true)
+	{
+		const uint32_t count = uint32_t(input.size());
+		if(count == 0)
+			return;
+
+		const uint32_t chunks = details::chunk_count(count, Count);
+		details::padded_vector<T> partials(chunks);
+
+		details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+		{
+			T partial = identity;
+			const uint32_t end = details::chunk_begin(chunk + 1, chunks, count);
+			for(uint32_t i = details::chunk_begin(chunk, chunks, count); i < end; ++i)
+				partial = op(partial, input[i]);
+			partials[chunk].m_value = partial;
+		});
+
+		T offset = identity;
+		for(uint32_t i = 0; i < chunks; ++i)
+		{
+			const T total = partials[i].m_value;
+			partials[i].m_value = offset;
+			offset = op(offset, total);
+		}
+
+		details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+		{
+			T sum = partials[chunk].m_value;
+			const uint32_t end = details::chunk_begin(chunk + 1, chunks, count);
+			for(uint32_t i = details::chunk_begin(chunk, chunks, count); i < end; ++i)
+			{
+				const T value = input[i];
+				if(inclusive)
+					output[i] = sum = op(sum, value);
+				else
+				{
+					output[i] = sum;
+					sum = op(sum, value);
+				}
+			}
+		});
+	}
+
+	// stable merge sort : chunks are sorted in parallel, then each merge pass is split along merge paths,
+	// so that all jobs keep merging in parallel up to the last pass, greater follows the quicksort() convention
+	template <uint32_t Count, class T, class Pred>
+	void parallel_sort(JobSystem& js, Job* parent, span<T> data, Pred greater)
+	{
+		const uint32_t count = uint32_t(data.size());
+		uint32_t chunks = 1;
+		while(chunks * 2 <= details::chunk_count(count, Count))
+			chunks *= 2;
+
+		vector<T> scratch(count);
+		T* source = data.data();
+		T* dest = scratch.data();
+
+		details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+		{
+			const uint32_t begin = details::chunk_begin(chunk, chunks, count);
+			const uint32_t end = details::chunk_begin(chunk + 1, chunks, count);
+			details::merge_sort(source + begin, dest + begin, end - begin, greater);
+		});
+
+		for(uint32_t width = 1; width < chunks; width *= 2)
+		{
+			details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+			{
+				// each job writes the chunk-sized slice of the output of the merge pair it falls in
+				const uint32_t pair = chunk / (width * 2);
+				const uint32_t first = details::chunk_begin(pair * width * 2, chunks, count);
+				const uint32_t middle = details::chunk_begin(pair * width * 2 + width, chunks, count);
+				const uint32_t last = details::chunk_begin(pair * width * 2 + width * 2, chunks, count);
+
+				const T* left = source + first;
+				const T* right = source + middle;
+				const uint32_t lc = middle - first;
+				const uint32_t rc = last - middle;
+
+				const uint32_t begin = details::chunk_begin(chunk, chunks, count) - first;
+				const uint32_t end = details::chunk_begin(chunk + 1, chunks, count) - first;
+
+				const uint32_t l = details::merge_path(left, lc, right, rc, begin, greater);
+				details::merge(left + l, lc - l, right + begin - l, rc - (begin - l), dest + first + begin, end - begin, greater);
+			});
+			swap(source, dest);
+		}
+
+		if(source != data.data())
+		{
+			details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+			{
+				const uint32_t end = details::chunk_begin(chunk + 1, chunks, count);
+				for(uint32_t i = details::chunk_begin(chunk, chunks, count); i < end; ++i)
+					data[i] = move(scratch[i]);
+			});
+		}
+	}
+
+	// stable LSD radix sort on the unsigned integer returned by key(const T&), 8 bits per pass
+	// scratch must be as large as data, passes where all keys share the same digit are skipped
+	template <uint32_t Count, class T, class K>
+	void parallel_radix_sort(JobSystem& js, Job* parent, span<T> data, span<T> scratch, K key)
+	{
+		using Key = decltype(key(data[0]));
+		static_assert(Key(-1) > Key(0), "radix sort keys must be unsigned integers");
+
+		struct Histogram { uint32_t m_counts[256]; };
+
+		const uint32_t count = uint32_t(data.size());
+		const uint32_t chunks = details::chunk_count(count, Count);
+		details::padded_vector<Histogram> histograms(chunks);
+
+		T* source = data.data();
+		T* dest = scratch.data();
+
+		for(uint32_t shift = 0; shift < sizeof(Key) * 8; shift += 8)
+		{
+			details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+			{
+				uint32_t* counts = histograms[chunk].m_value.m_counts;
+				memset(counts, 0, sizeof(Histogram));
+				const uint32_t end = details::chunk_begin(chunk + 1, chunks, count);
+				for(uint32_t i = details::chunk_begin(chunk, chunks, count); i < end; ++i)
+					counts[(key(source[i]) >> shift) & 0xff]++;
+			});
+
+			// offsets are laid out digit-major then chunk-major, which keeps the sort stable
+			uint32_t offset = 0;
+			bool skip = false;
+			for(uint32_t digit = 0; digit < 256; ++digit)
+			{
+				uint32_t total = 0;
+				for(uint32_t chunk = 0; chunk < chunks; ++chunk)
+				{
+					uint32_t& counter = histograms[chunk].m_value.m_counts[digit];
+					const uint32_t digits = counter;
+					counter = offset + total;
+					total += digits;
+				}
+				skip |= total == count;
+				offset += total;
+			}
+
+			if(skip)
+				continue;
+
+			details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+			{
+				uint32_t* offsets = histograms[chunk].m_value.m_counts;
+				const uint32_t end = details::chunk_begin(chunk + 1, chunks, count);
+				for(uint32_t i = details::chunk_begin(chunk, chunks, count); i < end; ++i)
+					dest[offsets[(key(source[i]) >> shift) & 0xff]++] = move(source[i]);
+			});
+			swap(source, dest);
+		}
+
+		if(source != data.data())
+		{
+			details::for_chunks(js, parent, chunks, [&](uint32_t chunk)
+			{
+				const uint32_t end = details::chunk_begin(chunk + 1, chunks, count);
+				for(uint32_t i = details::chunk_begin(chunk, chunks, count); i < end; ++i)
+					data[i] = move(source[i]);
+			});
+		}
+	}
 }
@@ -2,6 +2,8 @@
 #include <stl/span.h>
 #include <stl/math.h>
 #include <stl/algorithm.h>
+#include <stl/bitset.h>
+#include <stl/allocator.h>
 #include <infra/AlignedAlloc.h>
 #include <infra/Arena.h>
 #include <infra/Thread.h>
@@ -16,21 +18,12 @@
 #include <atomic>
 #include <thread>
 
-#include <condition_variable>
-#include <mutex>
-
-#include <immintrin.h>
+#if defined __i386__ || defined __x86_64__ || defined _M_IX86 || defined _M_X64
+#   include <immintrin.h>
+#endif
 
 #include <Tracy.hpp>
 
-#define __i386__
-
-#if defined __i386__ || defined __x86_64__
-#   define HAS_HYPER_THREADING 0      // on x86 we assume we have hyper-threading.
-#else
-#   define HAS_HYPER_THREADING 0
-#endif
-
 #if defined __EMSCRIPTEN__
 #   define HAS_THREADING 0
 #else
@@ -42,59 +35,158 @@
 #   define WAIT_FOR_EVENT()       __wfe()
 #elif defined __EMSCRIPTEN__
 #   define WAIT_FOR_EVENT()
+#elif defined __i386__ || defined __x86_64__ || defined _M_IX86 || defined _M_X64
+#   define WAIT_FOR_EVENT()       _mm_pause()
 #else
-#   if defined __i386__ || defined __x86_64__
-#       define WAIT_FOR_EVENT()       _mm_pause();
-#   else
-#       define WAIT_FOR_EVENT()
-#   endif
+#   define WAIT_FOR_EVENT()
 #endif
 
 namespace mud
 {
 	thread_local JobSystem::ThreadState* s_thread_state(nullptr);
 
+	// dependency edges are kept out of the job itself, they are only touched by jobs that have predecessors or successors
+	struct alignas(CACHELINE_SIZE) JobLinks
+	{
+		std::atomic<uint32_t> dependencies;
+		uint8_t count;
+		alloc_tag tag;
+		JobPriority priority;
+		uint32_t continuations[JobSystem::MAX_CONTINUATIONS];
+	};
+
+	static_assert(sizeof(JobLinks) == CACHELINE_SIZE, "JobLinks must be one cache line");
+
+	// the first slot of each segment is reserved for this header, so that a job index can be computed from its address
+	// it also means index 0 is never a valid job, which the work queues use as their empty value
+	struct alignas(CACHELINE_SIZE) JobSegment
+	{
+		uint32_t index;
+		uint32_t owner;
+		JobLinks* links;
+	};
+
+	static_assert(sizeof(JobSegment) <= CACHELINE_SIZE, "JobSegment must fit in the first job slot");
+
+	static constexpr size_t pow2_ceil(size_t value)
+	{
+		size_t pow2 = 1;
+		while(pow2 < value)
+			pow2 *= 2;
+		return pow2;
+	}
+
+	class JobSegments
+	{
+	public:
+		static constexpr uint32_t Shift = 10;
+		static constexpr uint32_t Mask = JobSystem::SEGMENT_JOB_COUNT - 1;
+		// segments are aligned on their size, so that segment() finds the header by masking a job address : on 32-bit a job is 96 bytes, so the size is rounded up
+		static constexpr size_t Size = pow2_ceil(JobSystem::SEGMENT_JOB_COUNT * sizeof(Job));
+		static_assert((1U << Shift) == JobSystem::SEGMENT_JOB_COUNT, "Shift doesn't match SEGMENT_JOB_COUNT");
+		static_assert((Size & (Size - 1)) == 0, "segment size must be a power of two to be used as a mask");
+
+		~JobSegments()
+		{
+			for(uint32_t i = 0, n = m_count.load(std::memory_order_relaxed); i < n; ++i)
+			{
+				aligned_free(segment(m_segments[i]).links);
+				aligned_free(m_segments[i]);
+			}
+		}
+
+		inline Job* job(uint32_t index) const
+		{
+			return m_segments[index >> Shift] + (index & Mask);
+		}
+
+		static inline JobSegment& segment(const Job* job)
+		{
+			return *reinterpret_cast<JobSegment*>(uintptr_t(job) & ~uintptr_t(Size - 1));
+		}
+
+		static inline uint32_t slot(const Job* job)
+		{
+			return uint32_t(job - reinterpret_cast<const Job*>(&segment(job)));
+		}
+
+		static inline uint32_t index(const Job* job)
+		{
+			return (segment(job).index << Shift) | slot(job);
+		}
+
+		static inline JobLinks& links(const Job* job)
+		{
+			return segment(job).links[slot(job)];
+		}
+
+		Job* create(uint32_t owner)
+		{
+			uint32_t count = m_count.load(std::memory_order_relaxed);
+			do {
+				if(count >= JobSystem::MAX_SEGMENT_COUNT)
+					return nullptr;
+			} while(!m_count.compare_exchange_weak(count, count + 1, std::memory_order_relaxed));
+
+			Job* jobs = static_cast<Job*>(aligned_alloc(Size, Size));
+			JobLinks* links = static_cast<JobLinks*>(aligned_alloc(JobSystem::SEGMENT_JOB_COUNT * sizeof(JobLinks), alignof(JobLinks)));
+			new(stl::placeholder(), jobs) JobSegment{ count, owner, links };
+			m_segments[count] = jobs;
+			return jobs;
+		}
+
+		uint32_t count() const { return m_count.load(std::memory_order_relaxed); }
+
+		std::atomic<uint32_t> m_count = { 0 };
+		Job* m_segments[JobSystem::MAX_SEGMENT_COUNT] = {};
+	};
+
 	template <size_t Count>
 	class WorkQueue
 	{
 	public:
 		WorkQueue() {}
-		WorkQueue(Job* jobs) : m_jobs(jobs) {}
+		WorkQueue(JobSegments& segments) : m_segments(&segments) {}
 
-		Job* m_jobs = nullptr;
-		StealQueue<uint16_t, Count> m_queue;
+		JobSegments* m_segments = nullptr;
+		StealQueue<uint32_t, Count> m_queue;
 
-		inline void push(Job* job)
+		inline bool push(Job* job)
 		{
-			size_t index = job - m_jobs;
-			assert(index >= 0 && index < Count);
-			m_queue.push(uint16_t(index + 1));
+			if(m_queue.count() >= int32_t(Count))
+				return false;
+			m_queue.push(JobSegments::index(job));
+			return true;
 		}
 
 		inline Job* pop()
 		{
-			size_t index = m_queue.pop();
-			assert(index <= Count);
-			return !index ? nullptr : (m_jobs - 1) + index;
+			uint32_t index = m_queue.pop();
+			return !index ? nullptr : m_segments->job(index);
 		}
 
 		inline Job* steal()
 		{
-			size_t index = m_queue.steal();
-			assert(index <= Count);
-			return !index ? nullptr : (m_jobs - 1) + index;
+			uint32_t index = m_queue.steal();
+			return !index ? nullptr : m_segments->job(index);
 		}
 	};
 
 	struct alignas(CACHELINE_SIZE) JobSystem::ThreadState  // this causes 40-bytes padding // make sure storage is cache-line aligned
 	{
-		WorkQueue<MAX_JOB_COUNT> work_queue;
+		WorkQueue<WORK_QUEUE_SIZE> work_queues[size_t(JobPriority::Count)];
+
+		// jobs are popped only by the owning thread, but pushed back by whichever thread finishes them
+		alignas(CACHELINE_SIZE) AtomicFreeList free_jobs;
+
+		// a parked worker sleeps on this futex until another thread sets it
+		alignas(CACHELINE_SIZE) std::atomic<uint32_t> wake = { 0 };
 
 		// these are not accessed by the worker threads
 		alignas(CACHELINE_SIZE) JobSystem* js;    // this causes 56-bytes padding
 		std::thread thread;
 		uint32_t index;
-		uint32_t mask;
+		uint64_t mask;
 	};
 
 	static_assert((sizeof(Job) % CACHELINE_SIZE == 0) || (CACHELINE_SIZE % sizeof(Job) == 0),
@@ -104,14 +196,13 @@ namespace mud
 	{
 	public:
 		Impl()
-			: m_job_pool("JobSystem Job pool", MAX_JOB_COUNT * sizeof(Job))
-			, m_jobs(static_cast<Job*>(m_job_pool.current()))
 		{
 			UNUSED(padding);
 		}
 
 		void init(JobSystem& js, uint16_t num_threads, uint16_t adoptable_threads)
 		{
+			assert(num_threads + adoptable_threads <= 64);
 			m_thread_states = aligned_vector<ThreadState>(num_threads + adoptable_threads);
 
 			printf("INFO: job system running on %i worker threads\n", int(num_threads));
@@ -119,25 +210,68 @@ namespace mud
 			for(size_t i = 0, n = m_thread_states.size(); i < n; i++)
 			{
 				ThreadState& state = m_thread_states[i];
-				state.work_queue.m_jobs = m_jobs;
+				for(auto& queue : state.work_queues)
+					queue.m_segments = &m_segments;
 				state.index = uint32_t(i);
-				state.mask = uint32_t(1UL << i);
+				state.mask = uint64_t(1) << i;
 				state.js = &js;
-				if(i < size_t(num_threads))
+				this->grow(state);
+			}
+
+			m_tracer = construct<JobTracer>(uint32_t(m_thread_states.size()));
+
+			for(size_t i = 0; i < size_t(num_threads); i++)
+			{
+				ThreadState& state = m_thread_states[i];
+				state.thread = std::thread(&JobSystem::loop, &js, &state);
+			}
+		}
+
+		bool grow(ThreadState& state)
+		{
+			Job* const jobs = m_segments.create(state.index);
+			if(!jobs)
+				return false;
+
+			// push in reverse so that jobs are handed out in address order
+			for(size_t i = SEGMENT_JOB_COUNT - 1; i > 0; --i)
+				state.free_jobs.push(&jobs[i]);
+			return true;
+		}
+
+		Job* alloc(ThreadState& state)
+		{
+			void* p = state.free_jobs.pop();
+			if(!p) //[[unlikely]]
+			{
+				m_pool_overflows.fetch_add(1, std::memory_order_relaxed);
+				if(!this->grow(state))
 				{
-					state.thread = std::thread(&JobSystem::loop, &js, &state);
+					if(m_pool_exhausted.fetch_add(1, std::memory_order_relaxed) == 0)
+						printf("WARNING: job system pool exhausted (%i jobs), running jobs inline\n", int(MAX_JOB_COUNT));
+					return nullptr;
 				}
+				p = state.free_jobs.pop();
 			}
+			return new(stl::placeholder(), p) Job();
+		}
+
+		void free(Job* job)
+		{
+			const uint32_t owner = JobSegments::segment(job).owner;
+			job->~Job();
+			m_thread_states[owner].free_jobs.push(job);
 		}
 
 		static_assert(sizeof(ThreadState) % CACHELINE_SIZE == 0, "ThreadState doesn't align to a cache line");
 
 	public:
 		// these have thread contention, keep them together
-		std::mutex m_lock;
-		std::condition_variable m_condition;
+		std::atomic<uint64_t> m_parked = { 0 };               // mask of the workers sleeping on their futex
 		std::atomic<uint32_t> m_active_jobs = { 0 };
-		Arena<Job, AtomicFreeList> m_job_pool;
+		std::atomic<uint32_t> m_pool_overflows = { 0 };
+		std::atomic<uint32_t> m_pool_exhausted = { 0 };
+		std::atomic<uint32_t> m_queue_overflows = { 0 };
 
 #ifndef USE_STL
 		template <class T>
@@ -155,19 +289,23 @@ namespace mud
 			aligned_vector<ThreadState> m_thread_states;      // actual data is stored offline
 		std::atomic<bool> m_exit_requested = { 0 };           // this one is almost never written
 		std::atomic<uint16_t> m_adopted_threads = { 0 };      // this one is almost never written
-		Job* const m_jobs;									  // base for conversion to indices
+		JobSegments m_segments;                               // base for conversion to indices
+		JobSystemConfig m_config;
+		CpuTopology m_topology;
+		unique<JobTracer> m_tracer;
 	};
 
-	JobSystem::JobSystem(uint16_t num_threads, uint16_t adoptable_threads)
+	JobSystem::JobSystem(uint16_t num_threads, uint16_t adoptable_threads, const JobSystemConfig& config)
 		: m_impl(construct<Impl>())
 	{
+		m_impl->m_config = config;
+		m_impl->m_topology = cpu_topology();
+
 		if(num_threads == 0)
 		{
-			uint32_t hardware_threads = std::thread::hardware_concurrency();
-			if(HAS_HYPER_THREADING)
-				num_threads = uint16_t(hardware_threads / 2 - 1);
-			else
-				num_threads = uint16_t(hardware_threads - 1);
+			const CpuTopology& topology = m_impl->m_topology;
+			uint32_t hardware_threads = config.m_smt ? topology.m_logical : topology.m_physical;
+			num_threads = uint16_t(max(hardware_threads, 1U) - 1);
 		}
 		num_threads = min(uint16_t(HAS_THREADING ? 32 : 0), num_threads);
 
@@ -188,6 +326,21 @@ namespace mud
 		}
 	}
 
+	JobSystem::Stats JobSystem::stats() const
+	{
+		Stats stats;
+		stats.m_segments = m_impl->m_segments.count();
+		stats.m_pool_overflows = m_impl->m_pool_overflows.load(std::memory_order_relaxed);
+		stats.m_pool_exhausted = m_impl->m_pool_exhausted.load(std::memory_order_relaxed);
+		stats.m_queue_overflows = m_impl->m_queue_overflows.load(std::memory_order_relaxed);
+		return stats;
+	}
+
+	JobTracer& JobSystem::tracer()
+	{
+		return *m_impl->m_tracer;
+	}
+
 	JobSystem* JobSystem::instance()
 	{
 		ThreadState* const state = s_thread_state;
@@ -197,7 +350,12 @@ namespace mud
 	void JobSystem::shutdown()
 	{
 		m_impl->m_exit_requested.store(true, std::memory_order_relaxed);
-		m_impl->m_condition.notify_all();
+
+		for(ThreadState& state : m_impl->m_thread_states)
+		{
+			state.wake.store(1, std::memory_order_release);
+			futex_wake_all(state.wake);
+		}
 	}
 
 	uint32_t JobSystem::thread()
@@ -236,15 +394,27 @@ namespace mud
 		return m_impl->m_thread_states[index];
 	}
 
-	bool JobSystem::execute(ThreadState& state)
+	Job* JobSystem::pop(ThreadState& state, JobPriority priority)
 	{
-		Job* job = state.work_queue.pop();
+		auto& queue = state.work_queues[size_t(priority)];
+		Job* job = queue.pop();
 		if(job == nullptr)
 		{
 			ThreadState& steal_target = random_thread_state();
 			if(&steal_target != &state)
-				job = steal_target.work_queue.steal();
+			{
+				job = steal_target.work_queues[size_t(priority)].steal();
+				m_impl->m_tracer->record(state.index, job ? JobEvent::Steal : JobEvent::StealFailed, steal_target.index);
+			}
 		}
+		return job;
+	}
+
+	bool JobSystem::execute(ThreadState& state, JobPriority lowest)
+	{
+		Job* job = this->pop(state, JobPriority::Frame);
+		if(job == nullptr && lowest == JobPriority::Background)
+			job = this->pop(state, JobPriority::Background);
 
 		if(job)
 		{
@@ -252,68 +422,171 @@ namespace mud
 			assert(active_jobs);
 			UNUSED(active_jobs);
 
-			if(job->function) //[[likely]]
-			{
-				ZoneScopedN("job");
-				job->function(job->storage, *this, job);
-			}
-
-			finish(job);
+			this->call(job);
 		}
 		return job != nullptr;
 	}
 
+	void JobSystem::call(Job* job)
+	{
+		JobTracer& tracer = *m_impl->m_tracer;
+		const uint32_t thread = s_thread_state->index;
+		tracer.record(thread, JobEvent::JobBegin, JobSegments::index(job));
+
+		if(job->function) //[[likely]]
+		{
+			ZoneScopedN("job");
+			alloc_scope scope(JobSegments::links(job).tag);
+			job->function(job->storage, *this, job);
+		}
+
+		tracer.record(thread, JobEvent::JobEnd, JobSegments::index(job));
+		finish(job);
+	}
+
 	void JobSystem::loop(ThreadState* thread_state)
 	{
 		set_thread_name("JobSystem::loop");
 		set_thread_priority(ThreadPriority::Display);
-		set_thread_affinity(1 << (thread_state->index + 1));
+
+		if(m_impl->m_config.m_pin_threads)
+		{
+			// the first cpu is left to the main thread
+			const vector<uint32_t>& cpus = m_impl->m_topology.m_cpus;
+			set_thread_cpu(cpus[(thread_state->index + 1) % cpus.size()]);
+		}
 
 		s_thread_state = thread_state;
 
+		uint32_t idle = 0;
 		do {
-			if(!execute(*thread_state))
+			if(execute(*thread_state))
 			{
-				std::unique_lock<std::mutex> lock(m_impl->m_lock);
-				while(!exiting() && !(m_impl->m_active_jobs.load(std::memory_order_relaxed)))
-					m_impl->m_condition.wait(lock);
+				idle = 0;
+			}
+			else if(idle < m_impl->m_config.m_spin_count)
+			{
+				idle++;
+				WAIT_FOR_EVENT();
+			}
+			else
+			{
+				idle = 0;
+				this->park(*thread_state);
 			}
 		} while(!exiting());
 	}
-	
+
+	void JobSystem::park(ThreadState& state)
+	{
+		Impl& impl = *m_impl;
+		state.wake.store(0, std::memory_order_relaxed);
+		impl.m_parked.fetch_or(state.mask);
+
+		// both sides are sequentially consistent : we set our parked bit then read the active jobs, schedule() increments the active jobs then reads the parked mask
+		// so either we see the new job and don't sleep, or schedule() sees our bit and wakes us, unless it was queued with DONT_SIGNAL
+		if(!impl.m_active_jobs.load() && !exiting())
+		{
+			impl.m_tracer->record(state.index, JobEvent::ParkBegin);
+			futex_wait(state.wake, 0);
+			impl.m_tracer->record(state.index, JobEvent::ParkEnd);
+		}
+
+		impl.m_parked.fetch_and(~state.mask, std::memory_order_relaxed);
+	}
+
+	void JobSystem::wake()
+	{
+		Impl& impl = *m_impl;
+		uint64_t parked = impl.m_parked.load();
+		while(parked)
+		{
+			const uint64_t mask = parked & (~parked + 1);
+			if(impl.m_parked.fetch_and(~mask) & mask)
+			{
+				ThreadState& state = impl.m_thread_states[stl::ctz(mask)];
+				state.wake.store(1, std::memory_order_release);
+				futex_wake_one(state.wake);
+				return;
+			}
+			parked = impl.m_parked.load();
+		}
+	}
+
 	Job* JobSystem::create(Job* parent, JobFunc func)
 	{
 		parent = (parent == nullptr) ? m_master_job : parent;
-		Job* const job = m_impl->m_job_pool.make();
+		Job* const job = m_impl->alloc(this->state());
 		if(job) //[[likely]]
 		{
-			//printf("%i jobs\n", int(job - m_jobs));
-			size_t index = 0x7FFF;
+			uint32_t index = 0;
 			if(parent)
 			{
 				assert(parent->running_jobs.load(std::memory_order_relaxed) > 0);
 
 				parent->running_jobs.fetch_add(1, std::memory_order_relaxed);
-				index = parent - m_impl->m_jobs;
-				assert(index < MAX_JOB_COUNT);
+				index = JobSegments::index(parent);
 			}
 			job->function = func;
-			job->parent = uint16_t(index);
+			job->parent = index;
 			job->running_jobs.store(1, std::memory_order_relaxed);
+
+			JobLinks& links = JobSegments::links(job);
+			links.dependencies.store(0, std::memory_order_relaxed);
+			links.count = 0;
+			links.priority = parent ? JobSegments::links(parent).priority : JobPriority::Frame;
+			// the job allocates under the tag of the code that created it, whichever thread runs it
+			links.tag = stl::current_alloc_tag();
 		}
-		else
+		return job;
+	}
+
+	JobPriority JobSystem::priority(Job const* job) const
+	{
+		return JobSegments::links(job).priority;
+	}
+
+	void JobSystem::set_priority(Job* job, JobPriority priority)
+	{
+		JobSegments::links(job).priority = priority;
+	}
+
+	void JobSystem::depend(Job* job, Job* predecessor)
+	{
+		JobLinks& links = JobSegments::links(predecessor);
+		assert(links.count < MAX_CONTINUATIONS);
+
+		// the first dependency also accounts for the run() call, so that the job can't start before it's actually run
+		JobLinks& dependencies = JobSegments::links(job);
+		const uint32_t count = dependencies.dependencies.load(std::memory_order_relaxed);
+		dependencies.dependencies.store(count == 0 ? 2 : count + 1, std::memory_order_relaxed);
+
+		links.continuations[links.count++] = JobSegments::index(job);
+	}
+
+	void JobSystem::depend(Job* job, span<Job*> predecessors)
+	{
+		for(Job* predecessor : predecessors)
+			this->depend(job, predecessor);
+	}
+
+	void JobSystem::continuations(Job* job)
+	{
+		JobLinks& links = JobSegments::links(job);
+		for(uint32_t i = 0; i < links.count; ++i)
 		{
-			//printf("no jobs\n");
+			Job* const continuation = m_impl->m_segments.job(links.continuations[i]);
+			JobLinks& dependencies = JobSegments::links(continuation);
+			if(dependencies.dependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				this->schedule(continuation, 0);
 		}
-		return job;
 	}
 
 	void JobSystem::finish(Job* job)
 	{
-		auto& job_pool = m_impl->m_job_pool;
-		Job* const storage = m_impl->m_jobs;
+		Impl& impl = *m_impl;
 		do {
-			int32_t running_jobs = job->running_jobs.fetch_sub(1, std::memory_order_release) - 1;
+			int32_t running_jobs = job->running_jobs.fetch_sub(1, std::memory_order_acq_rel) - 1;
 			assert(running_jobs >= 0);
 			if(running_jobs > 0)
 			{
@@ -321,42 +594,76 @@ namespace mud
 			}
 			else
 			{
-				Job* const parent = job->parent == 0x7FFF ? nullptr : &storage[job->parent];
-				job_pool.destroy(job);
+				Job* const parent = job->parent == 0 ? nullptr : impl.m_segments.job(job->parent);
+				this->continuations(job);
+				impl.free(job);
 				job = parent;
 			}
 		} while(job);
 	}
 
 	void JobSystem::run(Job* job, uint32_t flags)
+	{
+		JobLinks& links = JobSegments::links(job);
+		if(flags & BACKGROUND)
+			links.priority = JobPriority::Background;
+
+		if(links.dependencies.load(std::memory_order_relaxed) != 0)
+		{
+			// consume the run token, if predecessors are still pending the last one will schedule the job
+			if(links.dependencies.fetch_sub(1, std::memory_order_acq_rel) != 1)
+				return;
+		}
+
+		this->schedule(job, flags);
+	}
+
+	void JobSystem::schedule(Job* job, uint32_t flags)
 	{
 		ThreadState& state = this->state();
 
-		uint32_t active_jobs = m_impl->m_active_jobs.fetch_add(1, std::memory_order_relaxed);
-		state.work_queue.push(job);
+		auto& queue = state.work_queues[size_t(JobSegments::links(job).priority)];
 
-		if(!(flags & DONT_SIGNAL))
+		m_impl->m_active_jobs.fetch_add(1);
+		if(!queue.push(job)) //[[unlikely]]
 		{
-			if(active_jobs)
-			{
-				{ std::lock_guard<std::mutex> lock(m_impl->m_lock); }
-				m_impl->m_condition.notify_one();
-			}
+			m_impl->m_active_jobs.fetch_sub(1, std::memory_order_relaxed);
+			m_impl->m_queue_overflows.fetch_add(1, std::memory_order_relaxed);
+			this->call(job);
+			return;
 		}
+
+		m_impl->m_tracer->record(state.index, JobEvent::QueueDepth, uint32_t(queue.m_queue.count()));
+
+		// the parked mask is checked after every increment of the active jobs, which park() relies on
+		if(!(flags & DONT_SIGNAL))
+			this->wake();
 	}
 
 	void JobSystem::wait(Job const* job)
 	{
 		assert(job);
 		ThreadState& state = this->state();
+
+		// waiting on a frame-critical job must never pick up a long background job, unless there are no workers to run the ones it might wait on
+		const JobPriority lowest = m_thread_count > 0 ? this->priority(job) : JobPriority::Background;
 		do {
-			if(!execute(state))
+			if(!execute(state, lowest))
 				WAIT_FOR_EVENT();
 		} while(!completed(job) && !exiting());
 
 		std::atomic_thread_fence(std::memory_order_acquire);
 	}
 
+	bool JobSystem::yield()
+	{
+		ThreadState& state = this->state();
+		bool executed = false;
+		while(execute(state, JobPriority::Frame))
+			executed = true;
+		return executed;
+	}
+
 	void JobSystem::adopt()
 	{
 		ThreadState* const state = s_thread_state;
@@ -2,7 +2,9 @@
 
 #include <stl/vector.h>
 #include <stl/memory.h>
+#include <stl/span.h>
 #include <jobs/Forward.h>
+#include <jobs/JobTrace.h>
 
 #include <cassert>
 #include <stl/stddef.h>
@@ -27,13 +29,43 @@ namespace mud
 	using JobFunc = void(*)(void*, JobSystem&, Job*);
 	using JobStorage = void*[JOB_PADDING];
 
+	// each worker has one queue per priority lane : frame-critical jobs are always executed and stolen first
+	// jobs created by a background job are background jobs too, a long background job should yield() regularly
+	export_ enum class JobPriority : uint16_t
+	{
+		Frame,
+		Background,
+		Count
+	};
+
+	export_ struct JobSystemConfig
+	{
+		uint32_t m_spin_count = 256;    // # of failed attempts at finding work before an idle worker parks on its futex
+		bool m_pin_threads = false;     // pin each worker thread to its own cpu, physical cores first
+		bool m_smt = false;             // when the thread count is automatic, also use SMT siblings
+	};
+
 	export_ class refl_ nocopy_ MUD_JOBS_EXPORT JobSystem
 	{
-		static constexpr size_t MAX_JOB_COUNT = 4096;
-		static_assert(MAX_JOB_COUNT <= 0x7FFE, "MAX_JOB_COUNT must be <= 0x7FFE");
+	public:
+		// jobs are allocated in segments owned by each thread, a thread grows its pool by one segment when it runs out
+		static constexpr size_t SEGMENT_JOB_COUNT = 1024;
+		static constexpr size_t MAX_SEGMENT_COUNT = 256;
+		static constexpr size_t MAX_JOB_COUNT = SEGMENT_JOB_COUNT * MAX_SEGMENT_COUNT;
+		static constexpr size_t WORK_QUEUE_SIZE = 16384;
+		static constexpr size_t MAX_CONTINUATIONS = 14;
+		static_assert(!(SEGMENT_JOB_COUNT & (SEGMENT_JOB_COUNT - 1)), "SEGMENT_JOB_COUNT must be a power of two");
+
+		struct Stats
+		{
+			uint32_t m_segments = 0;           // # of job segments allocated
+			uint32_t m_pool_overflows = 0;     // # of times a thread ran out of jobs and had to grow its pool
+			uint32_t m_pool_exhausted = 0;     // # of jobs that couldn't be created at all, the work then runs inline
+			uint32_t m_queue_overflows = 0;    // # of jobs executed inline because the work queue was full
+		};
 
 	public:
-		explicit JobSystem(uint16_t num_threads = 0, uint16_t adoptable_threads = 1);
+		explicit JobSystem(uint16_t num_threads = 0, uint16_t adoptable_threads = 1, const JobSystemConfig& config = {});
 
 		~JobSystem();
 
@@ -44,12 +76,20 @@ namespace mud
 
 		uint32_t thread();
 
-		enum runFlags { DONT_SIGNAL = 0x1 };
+		enum runFlags { DONT_SIGNAL = 0x1, BACKGROUND = 0x2 };
 
+		// jobs are allocated from the segments of the calling thread, which must be a worker or have called adopt()
 		Job* create(Job* parent, JobFunc func);
 		void run(Job* job, uint32_t flags = 0);
 		void wait(Job const* job);
 
+		// executes pending frame-critical jobs from inside a background job, returns whether any job was executed
+		bool yield();
+
+		// jobs inherit the priority of their parent when they are created, so set it before creating children
+		JobPriority priority(Job const* job) const;
+		void set_priority(Job* job, JobPriority priority);
+
 		void complete(Job* job)
 		{
 			run(job);
@@ -58,11 +98,22 @@ namespace mud
 
 		void finish(Job* job);
 
+		// declares that job can only start once predecessor and all its children have completed
+		// both jobs must not have been run yet, and a job can have at most MAX_CONTINUATIONS successors
+		// running a job with pending predecessors defers it : the last predecessor to complete schedules it
+		void depend(Job* job, Job* predecessor);
+		void depend(Job* job, span<Job*> predecessors);
+
 		Job* job(Job* parent = nullptr) { return this->create(parent, nullptr); }
 
 		template <class T>
 		Job* job(Job* parent, T functor);
 
+		Stats stats() const;
+
+		// disabled by default, see JobTracer::enable()
+		JobTracer& tracer();
+
 		struct ThreadState;
 
 	private:
@@ -75,7 +126,13 @@ namespace mud
 		bool exiting() const;
 
 		void loop(ThreadState* state);
-		bool execute(ThreadState& state);
+		void park(ThreadState& state);
+		void wake();
+		Job* pop(ThreadState& state, JobPriority priority);
+		bool execute(ThreadState& state, JobPriority lowest = JobPriority::Background);
+		void call(Job* job);
+		void schedule(Job* job, uint32_t flags);
+		void continuations(Job* job);
 
 		struct Impl;
 		unique<Impl> m_impl;
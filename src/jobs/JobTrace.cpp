@@ -0,0 +1,179 @@
+#include <stl/vector.hpp>
+#include <stl/math.h>
+#include <jobs/JobTrace.h>
+
+#include <cassert>
+#include <cstdio>
+#include <chrono>
+
+namespace mud
+{
+	namespace
+	{
+		bool begins(JobEvent event) { return event == JobEvent::JobBegin || event == JobEvent::ParkBegin; }
+		bool ends(JobEvent event) { return event == JobEvent::JobEnd || event == JobEvent::ParkEnd; }
+
+		// a window cuts through spans : ends before the first begin and begins after the last end are dropped
+		// jobs and parking nest on a thread, as do the spans of a trace, so they are matched on a single stack
+		void balance(vector<JobTraceEvent>& events)
+		{
+			vector<size_t> open;
+			vector<bool> dropped(events.size(), false);
+			for(size_t i = 0; i < events.size(); ++i)
+			{
+				if(begins(events[i].m_event))
+					open.push_back(i);
+				else if(ends(events[i].m_event))
+				{
+					if(open.empty())
+						dropped[i] = true;
+					else
+						open.pop_back();
+				}
+			}
+
+			for(size_t i : open)
+				dropped[i] = true;
+
+			size_t count = 0;
+			for(size_t i = 0; i < events.size(); ++i)
+				if(!dropped[i])
+					events[count++] = events[i];
+			events.resize(count);
+		}
+	}
+
+	JobTracer::JobTracer(uint32_t num_threads, uint32_t capacity)
+		: m_capacity(capacity)
+		, m_mask(capacity - 1)
+	{
+		assert(!(capacity & (capacity - 1)) && "trace capacity must be a power of two");
+		for(uint32_t i = 0; i < num_threads; ++i)
+			m_rings.push_back(construct<Ring>(capacity));
+	}
+
+	JobTracer::~JobTracer()
+	{}
+
+	uint64_t JobTracer::now()
+	{
+		using namespace std::chrono;
+		return uint64_t(duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count());
+	}
+
+	void JobTracer::frame()
+	{
+		const uint64_t frame = m_frame.load(std::memory_order_relaxed);
+		m_frames[frame % MAX_FRAMES].store(now(), std::memory_order_relaxed);
+		m_frame.store(frame + 1, std::memory_order_release);
+	}
+
+	vector<JobTraceEvent> JobTracer::events(uint32_t thread, uint64_t begin, uint64_t end) const
+	{
+		const Ring& ring = *m_rings[thread];
+
+		const uint64_t head = ring.m_head.load(std::memory_order_acquire);
+		const uint64_t first = head > m_capacity ? head - m_capacity : 0;
+
+		vector<JobTraceEvent> events;
+		events.reserve(size_t(head - first));
+		for(uint64_t i = first; i < head; ++i)
+		{
+			const std::atomic<uint64_t>* words = ring.m_words + (i & m_mask) * 2;
+			const uint64_t word = words[1].load(std::memory_order_relaxed);
+			events.push_back({ words[0].load(std::memory_order_relaxed), JobEvent(word >> 32), uint32_t(word) });
+		}
+
+		// the writer doesn't wait for us : drop whatever it may have overwritten while we were copying
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const uint64_t after = ring.m_head.load(std::memory_order_relaxed);
+		const uint64_t valid = after > m_capacity ? after - m_capacity : 0;
+		const size_t dropped = valid > first ? size_t(min(valid - first, head - first)) : 0;
+
+		vector<JobTraceEvent> result;
+		for(size_t i = dropped; i < events.size(); ++i)
+			if(events[i].m_time >= begin && events[i].m_time <= end)
+				result.push_back(events[i]);
+		return result;
+	}
+
+	bool JobTracer::dump(const char* path, uint32_t frames) const
+	{
+		const uint64_t frame = m_frame.load(std::memory_order_acquire);
+		frames = min(frames, MAX_FRAMES - 1);
+		const uint64_t begin = frame >= frames && frames > 0 ? m_frames[(frame - frames) % MAX_FRAMES].load(std::memory_order_relaxed) : 0;
+		return this->dump(path, begin, now());
+	}
+
+	bool JobTracer::dump(const char* path, uint64_t begin, uint64_t end) const
+	{
+		FILE* file = fopen(path, "w");
+		if(!file)
+		{
+			printf("WARNING: could not open job trace file %s\n", path);
+			return false;
+		}
+
+		uint64_t origin = UINT64_MAX;
+		vector<vector<JobTraceEvent>> threads;
+		for(uint32_t i = 0; i < uint32_t(m_rings.size()); ++i)
+		{
+			threads.push_back(this->events(i, begin, end));
+			balance(threads.back());
+			if(!threads.back().empty())
+				origin = min(origin, threads.back().front().m_time);
+		}
+
+		auto us = [&](uint64_t time) { return double(time - origin) / 1000.0; };
+
+		fprintf(file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+		fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"JobSystem\"}}");
+
+		for(uint32_t t = 0; t < uint32_t(threads.size()); ++t)
+		{
+			fprintf(file, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", t, t);
+
+			for(const JobTraceEvent& event : threads[t])
+			{
+				const double ts = us(event.m_time);
+				switch(event.m_event)
+				{
+				case JobEvent::JobBegin:
+					fprintf(file, ",\n{\"name\":\"job\",\"cat\":\"job\",\"ph\":\"B\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"args\":{\"job\":%u}}", t, ts, event.m_value);
+					break;
+				case JobEvent::JobEnd:
+					fprintf(file, ",\n{\"ph\":\"E\",\"pid\":0,\"tid\":%u,\"ts\":%.3f}", t, ts);
+					break;
+				case JobEvent::Steal:
+				case JobEvent::StealFailed:
+					fprintf(file, ",\n{\"name\":\"%s\",\"cat\":\"steal\",\"ph\":\"i\",\"s\":\"t\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"args\":{\"victim\":%u}}",
+							event.m_event == JobEvent::Steal ? "steal" : "steal failed", t, ts, event.m_value);
+					break;
+				case JobEvent::ParkBegin:
+					fprintf(file, ",\n{\"name\":\"parked\",\"cat\":\"park\",\"ph\":\"B\",\"pid\":0,\"tid\":%u,\"ts\":%.3f}", t, ts);
+					break;
+				case JobEvent::ParkEnd:
+					fprintf(file, ",\n{\"ph\":\"E\",\"pid\":0,\"tid\":%u,\"ts\":%.3f}", t, ts);
+					break;
+				case JobEvent::QueueDepth:
+					fprintf(file, ",\n{\"name\":\"queue %u\",\"ph\":\"C\",\"pid\":0,\"tid\":%u,\"ts\":%.3f,\"args\":{\"depth\":%u}}", t, t, ts, event.m_value);
+					break;
+				default:
+					break;
+				}
+			}
+		}
+
+		const uint64_t frame = m_frame.load(std::memory_order_acquire);
+		for(uint64_t i = frame > MAX_FRAMES ? frame - MAX_FRAMES : 0; i < frame; ++i)
+		{
+			const uint64_t time = m_frames[i % MAX_FRAMES].load(std::memory_order_relaxed);
+			if(time >= begin && time <= end && time >= origin)
+				fprintf(file, ",\n{\"name\":\"frame\",\"ph\":\"i\",\"s\":\"g\",\"pid\":0,\"tid\":0,\"ts\":%.3f}", us(time));
+		}
+
+		fprintf(file, "\n]}\n");
+		fclose(file);
+		return true;
+	}
+}
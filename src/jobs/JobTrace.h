@@ -0,0 +1,88 @@
+#pragma once
+
+#include <stl/vector.h>
+#include <stl/memory.h>
+#include <jobs/Forward.h>
+
+#include <stdint.h>
+#include <atomic>
+
+namespace mud
+{
+	export_ enum class JobEvent : uint32_t
+	{
+		JobBegin,
+		JobEnd,
+		Steal,          // value is the victim thread
+		StealFailed,    // value is the victim thread
+		ParkBegin,
+		ParkEnd,
+		QueueDepth,     // value is the depth of the queue the job was pushed to
+		Count
+	};
+
+	struct JobTraceEvent
+	{
+		uint64_t m_time;     // nanoseconds
+		JobEvent m_event;
+		uint32_t m_value;
+	};
+
+	// lock-free per-thread ring buffers of job system events, each one is only written by its own thread
+	// events are always recorded in builds without Tracy, the cost when disabled is one relaxed load per event
+	export_ class MUD_JOBS_EXPORT JobTracer
+	{
+	public:
+		// events are stored as pairs of relaxed atomic words, so that dumping while workers are recording is well-defined
+		struct alignas(64) Ring
+		{
+			Ring(uint32_t capacity) : m_words(new std::atomic<uint64_t>[capacity * 2]) {}
+			~Ring() { delete[] m_words; }
+			std::atomic<uint64_t> m_head = { 0 };
+			std::atomic<uint64_t>* m_words;
+		};
+
+	public:
+		JobTracer(uint32_t num_threads, uint32_t capacity = 1 << 14);
+		~JobTracer();
+
+		static uint64_t now();
+
+		void enable(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+		bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+		inline void record(uint32_t thread, JobEvent event, uint32_t value = 0)
+		{
+			if(!this->enabled())
+				return;
+			Ring& ring = *m_rings[thread];
+			const uint64_t head = ring.m_head.load(std::memory_order_relaxed);
+			std::atomic<uint64_t>* words = ring.m_words + (head & m_mask) * 2;
+			words[0].store(now(), std::memory_order_relaxed);
+			words[1].store(uint64_t(event) << 32 | value, std::memory_order_relaxed);
+			ring.m_head.store(head + 1, std::memory_order_release);
+		}
+
+		// marks the beginning of a frame, frame windows can then be dumped
+		void frame();
+
+		// copies the events of one thread recorded in [begin, end], events overwritten while reading are dropped
+		vector<JobTraceEvent> events(uint32_t thread, uint64_t begin, uint64_t end) const;
+
+		// writes the events of the last frames as a Chrome trace / Perfetto JSON file
+		// begin and end events whose pair is outside the window are dropped, so that they don't stretch to the edges of the trace
+		bool dump(const char* path, uint32_t frames = 1) const;
+		bool dump(const char* path, uint64_t begin, uint64_t end) const;
+
+		uint32_t m_capacity;
+		uint64_t m_mask;
+		vector<unique<Ring>> m_rings;
+
+		static constexpr uint32_t MAX_FRAMES = 64;
+		std::atomic<uint64_t> m_frame = { 0 };
+		// written by frame() while dump() can read them from another thread
+		std::atomic<uint64_t> m_frames[MAX_FRAMES] = {};
+
+		std::atomic<bool> m_enabled = { false };
+	};
+}
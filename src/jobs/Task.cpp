@@ -0,0 +1,198 @@
+#include <stl/vector.hpp>
+#include <jobs/Task.h>
+
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <atomic>
+#include <new>
+
+namespace mud
+{
+	namespace
+	{
+		constexpr size_t SIZE_CLASSES = 6;      // 128, 256, 512, 1024, 2048, 4096
+		constexpr size_t CACHE_FRAMES = 64;     // # of free frames a thread keeps in each size class, the others go back to the heap
+
+		static_assert(TaskFramePool::MIN_SIZE << (SIZE_CLASSES - 1) == TaskFramePool::MAX_SIZE, "size classes don't cover the pool");
+
+		struct FrameCache;
+
+		std::atomic<size_t> s_allocated = { 0 };
+
+		// in front of each frame, keeps it aligned like operator new does
+		struct alignas(16) FrameHeader
+		{
+			FrameCache* m_owner;
+		};
+
+		struct FrameNode
+		{
+			FrameNode* next;
+		};
+
+		// free frames of a thread : frames freed by their owner go straight to m_frames, others are pushed on m_returned, and drained by the owner when it runs out
+		struct FrameCache
+		{
+			FrameNode* m_frames[SIZE_CLASSES] = {};
+			size_t m_counts[SIZE_CLASSES] = {};
+			std::atomic<FrameNode*> m_returned[SIZE_CLASSES] = {};
+
+			void push(size_t index, FrameNode* node)
+			{
+				if(m_counts[index] >= CACHE_FRAMES)
+				{
+					s_allocated.fetch_sub(1, std::memory_order_relaxed);
+					::free(reinterpret_cast<FrameHeader*>(node) - 1);
+					return;
+				}
+				node->next = m_frames[index];
+				m_frames[index] = node;
+				m_counts[index]++;
+			}
+
+			FrameNode* pop(size_t index)
+			{
+				if(!m_frames[index])
+				{
+					FrameNode* node = m_returned[index].exchange(nullptr, std::memory_order_acquire);
+					while(node)
+					{
+						FrameNode* next = node->next;
+						this->push(index, node);
+						node = next;
+					}
+				}
+
+				FrameNode* node = m_frames[index];
+				if(node)
+				{
+					m_frames[index] = node->next;
+					m_counts[index]--;
+				}
+				return node;
+			}
+
+			void give_back(size_t index, FrameNode* node)
+			{
+				FrameNode* head = m_returned[index].load(std::memory_order_relaxed);
+				do
+					node->next = head;
+				while(!m_returned[index].compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+			}
+		};
+
+		// caches outlive their threads, since other threads might still give frames back to them : the cache of a thread that exits is given to the next one
+		struct FrameCaches
+		{
+			~FrameCaches()
+			{
+				for(FrameCache* cache : m_caches)
+				{
+					for(size_t index = 0; index < SIZE_CLASSES; ++index)
+						for(FrameNode* node : { cache->m_frames[index], cache->m_returned[index].load() })
+							while(node)
+							{
+								FrameNode* next = node->next;
+								::free(reinterpret_cast<FrameHeader*>(node) - 1);
+								node = next;
+							}
+					delete cache;
+				}
+			}
+
+			std::mutex m_mutex;
+			vector<FrameCache*> m_caches;
+			vector<FrameCache*> m_available;
+		};
+
+		FrameCaches& frame_caches()
+		{
+			static FrameCaches caches;
+			return caches;
+		}
+
+		struct ThreadFrameCache
+		{
+			ThreadFrameCache()
+			{
+				FrameCaches& caches = frame_caches();
+				std::lock_guard<std::mutex> lock(caches.m_mutex);
+				if(caches.m_available.empty())
+				{
+					m_cache = new FrameCache();
+					caches.m_caches.push_back(m_cache);
+				}
+				else
+				{
+					m_cache = caches.m_available.back();
+					caches.m_available.pop_back();
+				}
+			}
+
+			~ThreadFrameCache()
+			{
+				FrameCaches& caches = frame_caches();
+				std::lock_guard<std::mutex> lock(caches.m_mutex);
+				caches.m_available.push_back(m_cache);
+			}
+
+			FrameCache* m_cache;
+		};
+
+		FrameCache& thread_frame_cache()
+		{
+			thread_local ThreadFrameCache cache;
+			return *cache.m_cache;
+		}
+
+		inline size_t size_class(size_t size)
+		{
+			size_t index = 0;
+			while((TaskFramePool::MIN_SIZE << index) < size)
+				index++;
+			return index;
+		}
+	}
+
+	void* TaskFramePool::alloc(size_t size)
+	{
+		if(size > MAX_SIZE)
+			return ::operator new(size);
+
+		const size_t index = size_class(size);
+		FrameCache& cache = thread_frame_cache();
+		if(FrameNode* node = cache.pop(index))
+			return node;
+
+		FrameHeader* header = static_cast<FrameHeader*>(::malloc(sizeof(FrameHeader) + (MIN_SIZE << index)));
+		// the tree builds without exceptions, and a coroutine can't start without its frame
+		if(!header)
+		{
+			printf("ERROR: out of memory allocating a task frame of %zu bytes\n", size_t(MIN_SIZE << index));
+			abort();
+		}
+		header->m_owner = &cache;
+		s_allocated.fetch_add(1, std::memory_order_relaxed);
+		return header + 1;
+	}
+
+	void TaskFramePool::free(void* frame, size_t size)
+	{
+		if(size > MAX_SIZE)
+			return ::operator delete(frame);
+
+		const size_t index = size_class(size);
+		FrameNode* node = static_cast<FrameNode*>(frame);
+		FrameCache* owner = (static_cast<FrameHeader*>(frame) - 1)->m_owner;
+		if(owner == &thread_frame_cache())
+			owner->push(index, node);
+		else
+			owner->give_back(index, node);
+	}
+
+	size_t TaskFramePool::allocated()
+	{
+		return s_allocated.load(std::memory_order_relaxed);
+	}
+}
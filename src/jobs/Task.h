@@ -0,0 +1,278 @@
+#pragma once
+
+#include <stl/move.h>
+#include <stl/new.h>
+#include <jobs/Forward.h>
+#include <jobs/JobSystem.h>
+#include <jobs/Job.h>
+
+#include <stddef.h>
+
+namespace mud
+{
+	// coroutine frames are recycled through per-thread free lists of a few size classes, so that starting a task doesn't hit the heap
+	// a frame freed on another thread is given back to the thread that allocated it, each thread keeps a bounded # of frames and frees the others
+	// frames larger than MAX_SIZE fall back to the heap
+	export_ class MUD_JOBS_EXPORT TaskFramePool
+	{
+	public:
+		static constexpr size_t MIN_SIZE = 128;
+		static constexpr size_t MAX_SIZE = 4096;
+
+		static void* alloc(size_t size);
+		static void free(void* frame, size_t size);
+
+		// # of pooled frames currently allocated from the heap, whether in use or cached
+		static size_t allocated();
+	};
+}
+
+#if defined __cpp_impl_coroutine && __cpp_impl_coroutine >= 201902L
+#define MUD_JOBS_COROUTINES
+#endif
+
+#ifdef MUD_JOBS_COROUTINES
+#include <coroutine>
+#include <exception>
+
+namespace mud
+{
+	template <class T = void>
+	class task;
+
+	namespace details
+	{
+		struct TaskPromiseBase
+		{
+			static void* operator new(size_t size) { return TaskFramePool::alloc(size); }
+			static void operator delete(void* frame, size_t size) { TaskFramePool::free(frame, size); }
+
+			struct FinalAwaiter
+			{
+				bool await_ready() noexcept { return false; }
+				void await_resume() noexcept {}
+
+				// symmetric transfer to whoever awaited us, so long chains of tasks don't grow the stack
+				template <class P>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<P> handle) noexcept
+				{
+					std::coroutine_handle<> continuation = handle.promise().m_continuation;
+					return continuation ? continuation : std::noop_coroutine();
+				}
+			};
+
+			std::suspend_always initial_suspend() noexcept { return {}; }
+			FinalAwaiter final_suspend() noexcept { return {}; }
+			void unhandled_exception() { std::terminate(); }
+
+			std::coroutine_handle<> m_continuation;
+		};
+
+		template <class T>
+		struct TaskPromise : public TaskPromiseBase
+		{
+			~TaskPromise() { if(m_has_value) this->value().~T(); }
+
+			task<T> get_return_object();
+
+			template <class U>
+			void return_value(U&& value) { new(stl::placeholder(), m_storage) T(static_cast<U&&>(value)); m_has_value = true; }
+
+			T& value() { return *reinterpret_cast<T*>(m_storage); }
+
+			alignas(T) char m_storage[sizeof(T)];
+			bool m_has_value = false;
+		};
+
+		template <>
+		struct TaskPromise<void> : public TaskPromiseBase
+		{
+			task<void> get_return_object();
+
+			void return_void() {}
+			void value() {}
+		};
+	}
+
+	// lazily started coroutine : the body runs when the task is awaited, and the awaiter resumes when it returns
+	// awaits suspend the coroutine without blocking the worker, which picks up other jobs in the meantime
+	template <class T>
+	class task
+	{
+	public:
+		using promise_type = details::TaskPromise<T>;
+		using Handle = std::coroutine_handle<promise_type>;
+
+		task() {}
+		explicit task(Handle handle) : m_handle(handle) {}
+		task(task&& other) : m_handle(other.m_handle) { other.m_handle = nullptr; }
+		task& operator=(task&& other) { if(m_handle) m_handle.destroy(); m_handle = other.m_handle; other.m_handle = nullptr; return *this; }
+		~task() { if(m_handle) m_handle.destroy(); }
+
+		task(const task&) = delete;
+		task& operator=(const task&) = delete;
+
+		bool done() const { return !m_handle || m_handle.done(); }
+
+		bool await_ready() const { return this->done(); }
+
+		std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting)
+		{
+			m_handle.promise().m_continuation = awaiting;
+			return m_handle;
+		}
+
+		T await_resume() { return move(m_handle.promise().value()); }
+
+		Handle m_handle;
+	};
+
+	template <>
+	inline void task<void>::await_resume() {}
+
+	namespace details
+	{
+		template <class T>
+		task<T> TaskPromise<T>::get_return_object() { return task<T>(task<T>::Handle::from_promise(*this)); }
+
+		inline task<void> TaskPromise<void>::get_return_object() { return task<void>(task<void>::Handle::from_promise(*this)); }
+
+		inline Job* resume_job(JobSystem& js, std::coroutine_handle<> handle, JobPriority priority)
+		{
+			Job* job = js.job(nullptr, [handle](JobSystem&, Job*) { handle.resume(); });
+			if(job && priority != JobPriority::Frame)
+				js.set_priority(job, priority);
+			return job;
+		}
+
+		struct ScheduleAwaiter
+		{
+			bool await_ready() { return false; }
+			void await_resume() {}
+
+			bool await_suspend(std::coroutine_handle<> handle)
+			{
+				Job* job = resume_job(m_js, handle, m_priority);
+				if(!job)
+					return false;
+				m_js.run(job);
+				return true;
+			}
+
+			JobSystem& m_js;
+			JobPriority m_priority;
+		};
+
+		struct JobAwaiter
+		{
+			bool await_ready() { return m_job == nullptr; }
+			void await_resume() {}
+
+			bool await_suspend(std::coroutine_handle<> handle)
+			{
+				Job* resume = resume_job(m_js, handle, m_js.priority(m_job));
+				if(!resume)
+				{
+					m_js.complete(m_job);
+					return false;
+				}
+				m_js.depend(resume, m_job);
+				m_js.run(resume);
+				m_js.run(m_job);
+				return true;
+			}
+
+			JobSystem& m_js;
+			Job* m_job;
+		};
+
+		struct DetachedTask
+		{
+			struct promise_type : public TaskPromiseBase
+			{
+				DetachedTask get_return_object() { return {}; }
+				std::suspend_never initial_suspend() noexcept { return {}; }
+				std::suspend_never final_suspend() noexcept { return {}; }
+				void return_void() {}
+			};
+		};
+
+		// the signal is the last thing the coroutine touches outside its own frame, it destroys itself right after
+		template <class T>
+		DetachedTask signal(task<T>& awaited, T& result, JobSystem& js, Job* pending, std::atomic<bool>& done)
+		{
+			result = co_await awaited;
+			if(pending)
+				js.run(pending);
+			else
+				done.store(true, std::memory_order_release);
+		}
+
+		inline DetachedTask signal(task<void>& awaited, JobSystem& js, Job* pending, std::atomic<bool>& done)
+		{
+			co_await awaited;
+			if(pending)
+				js.run(pending);
+			else
+				done.store(true, std::memory_order_release);
+		}
+
+		template <class Signal>
+		void sync_wait(JobSystem& js, Signal signal)
+		{
+			// done only completes once its pending child is run by the signal, so waiting on it keeps this thread executing jobs
+			// it is a background job so that the wait also executes the background jobs the task might be suspended on
+			std::atomic<bool> finished = { false };
+			Job* done = js.job();
+			if(done)
+				js.set_priority(done, JobPriority::Background);
+			Job* pending = done ? js.job(done) : nullptr;
+
+			signal(pending, finished);
+
+			if(pending)
+				js.complete(done);
+			else
+			{
+				if(done)
+					js.complete(done);
+				while(!finished.load(std::memory_order_acquire))
+					js.yield();
+			}
+		}
+	}
+
+	// resumes the awaiting coroutine in a job on one of the workers
+	inline details::ScheduleAwaiter schedule(JobSystem& js, JobPriority priority = JobPriority::Frame)
+	{
+		return { js, priority };
+	}
+
+	// runs a job that hasn't been run yet, and resumes the awaiting coroutine once it and all its children have completed
+	inline details::JobAwaiter async_run(JobSystem& js, Job* job)
+	{
+		return { js, job };
+	}
+
+	// starts a task on a worker, the task frame is released when it returns
+	inline details::DetachedTask spawn(JobSystem& js, task<void> work, JobPriority priority = JobPriority::Frame)
+	{
+		co_await schedule(js, priority);
+		co_await work;
+	}
+
+	// runs a task to completion from a job system thread, executing other jobs while it is suspended
+	template <class T>
+	T sync_wait(JobSystem& js, task<T> work)
+	{
+		T result = {};
+		details::sync_wait(js, [&](Job* pending, std::atomic<bool>& done) { return details::signal(work, result, js, pending, done); });
+		return result;
+	}
+
+	inline void sync_wait(JobSystem& js, task<void> work)
+	{
+		details::sync_wait(js, [&](Job* pending, std::atomic<bool>& done) { return details::signal(work, js, pending, done); });
+	}
+}
+#endif
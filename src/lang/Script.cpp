@@ -45,6 +45,8 @@ namespace mud
 
 	void Interpreter::call(const TextScript& script, span<void*> args, void*& result)
 	{
+		alloc_scope tag(alloc_tag::lang);
+
 		m_script = &script;
 		script.m_runtime_errors.clear();
 		script.m_compile_errors.clear();
@@ -205,7 +205,6 @@ namespace mud
 		// members
 		static Member members[] = {
 			{ t, offsetof(mud::Call, m_args), type<stl::vector<mud::Var>>(), "args", nullptr, Member::NonMutable, nullptr },
-			{ t, offsetof(mud::Call, m_vargs), type<stl::vector<void*>>(), "vargs", nullptr, Member::NonMutable, nullptr },
 			{ t, offsetof(mud::Call, m_result), type<mud::Var>(), "result", nullptr, Member::NonMutable, nullptr }
 		};
 		// methods
@@ -1,4 +1,5 @@
 #include <pool/Forward.h>
+#include <pool/ConcurrentPool.h>
 #include <pool/ObjectPool.h>
 #include <pool/Pool.h>
 #include <pool/SparsePool.h>
@@ -0,0 +1,140 @@
+//  Copyright (c) 2019 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <infra/Arena.h>
+#include <infra/Thread.h>
+#include <type/Ref.h>
+#include <pool/Forward.h>
+#include <pool/Pool.h>
+#include <pool/SparsePool.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <mutex>
+
+namespace mud
+{
+	// slots are allocated in chunks twice as large as the previous one, that never move
+	// each slot has a fixed handle, from which it is found with a few bit operations
+	//
+	// each thread allocates from and frees to the cache of its thread_index(), and batches of free slots go through a global lock-free list
+	// threads past MAX_THREADS have no cache and go straight to the list
+	// the whole list is taken at once, so that it's never subject to ABA, and the batches not needed are pushed back in one exchange
+	// the mutex is only taken to allocate a new chunk, once no batch is left in the list or on its way back
+	export_ template <class T>
+	class ConcurrentSlots
+	{
+	public:
+		static constexpr uint32_t MAX_THREADS = 64;
+		static constexpr uint32_t MAX_CHUNKS = 32;
+		static constexpr uint32_t BATCH = 32;
+
+		// the first chunk holds size slots, rounded up to a power of two multiple of BATCH
+		ConcurrentSlots(uint32_t size = 1024);
+		~ConcurrentSlots();
+
+		ConcurrentSlots(const ConcurrentSlots& other) = delete;
+		ConcurrentSlots& operator=(const ConcurrentSlots& other) = delete;
+
+		// returns nullptr once all handles are used
+		T* alloc();
+		void free(T* object);
+
+		uint32_t handle(T* object) const;
+		T& get(uint32_t handle) const;
+
+		size_t capacity() const;
+
+		// releases all the chunks : it isn't thread-safe, and objects still alive aren't destroyed
+		void clear();
+
+	public:
+		struct Slot
+		{
+			union
+			{
+				// the first word links the batches in the global list, the second the slots of a batch
+				// the third word is set on batches pushed back, to the last batch of the run they were pushed with
+				struct { Slot* m_next_batch; Slot* m_next; Slot* m_last_batch; };
+				alignas(T) unsigned char m_value[sizeof(T)];
+			};
+			uint32_t m_handle;
+		};
+
+		struct alignas(64) Cache
+		{
+			Slot* m_head = nullptr;
+			uint32_t m_count = 0;
+		};
+
+	private:
+		void push(Slot* batch);
+		Slot* pop();
+		Slot* take();
+		Slot* grow();
+
+		uint32_t m_size;
+		uint32_t m_max_chunks;
+		std::atomic<uint32_t> m_chunk_count = { 0 };
+		Slot* m_chunks[MAX_CHUNKS] = {};
+
+		AtomicFreeList m_free;
+		// batches in the list, or taken with it and about to be pushed back
+		std::atomic<int32_t> m_batches = { 0 };
+		std::mutex m_mutex;
+
+		Cache m_caches[MAX_THREADS];
+	};
+
+	// TPool that can allocate and free from any thread
+	// the pool doesn't track the objects that are alive, so they can't be iterated, and must be destroyed before clearing the pool
+	export_ template <class T>
+	class ConcurrentPool : public Pool
+	{
+	public:
+		ConcurrentPool(uint32_t size = 1024);
+		~ConcurrentPool();
+
+		T* talloc();
+		void tdestroy(T& object);
+		void tfree(T& object);
+
+		virtual void alloc(Ref& ref);
+		virtual Ref alloc();
+
+		virtual void destroy(Ref object);
+		virtual void free(Ref object);
+
+		virtual void reset();
+		virtual void clear();
+
+		template <class... Types>
+		T& construct(Types&&... args);
+
+		ConcurrentSlots<T> m_slots;
+	};
+
+	// SparsePool that can create and destroy from any thread
+	// objects stay in place instead of being packed, and are found with the handle of their slot
+	export_ template <class T>
+	class ConcurrentSparsePool : public HandlePool
+	{
+	public:
+		ConcurrentSparsePool(uint32_t size = 1024);
+		~ConcurrentSparsePool();
+
+		template <class... Types>
+		uint32_t create(Types&&... args);
+
+		void destroy(uint32_t handle);
+		T& get(uint32_t handle);
+
+		virtual void clear();
+
+		ConcurrentSlots<T> m_slots;
+	};
+}
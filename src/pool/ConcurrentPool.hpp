@@ -0,0 +1,294 @@
+//  Copyright (c) 2019 Hugo Amiard hugo.amiard@laposte.net
+//  This software is provided 'as-is' under the zlib License, see the LICENSE.txt file.
+//  This notice and the license may not be removed or altered from any source distribution.
+
+#pragma once
+
+#include <stl/new.h>
+#include <stl/bitset.h>
+#include <infra/AlignedAlloc.h>
+#include <pool/ConcurrentPool.h>
+#include <type/RefVal.h>
+
+#include <cstdio>
+#include <thread>
+
+namespace mud
+{
+	template <class T>
+	ConcurrentSlots<T>::ConcurrentSlots(uint32_t size)
+		: m_size(BATCH)
+	{
+		while(m_size < size)
+			m_size *= 2;
+
+		// handles of all chunks must fit in 32 bits
+		m_max_chunks = 0;
+		while(m_max_chunks < MAX_CHUNKS && (uint64_t(m_size) << (m_max_chunks + 1)) - m_size <= UINT32_MAX)
+			m_max_chunks++;
+	}
+
+	template <class T>
+	ConcurrentSlots<T>::~ConcurrentSlots()
+	{
+		this->clear();
+	}
+
+	template <class T>
+	typename ConcurrentSlots<T>::Slot* ConcurrentSlots<T>::grow()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		// another thread might have grown the pool, or be pushing batches back
+		while(m_batches.load(std::memory_order_acquire) > 0)
+		{
+			if(Slot* batch = this->pop())
+				return batch;
+			std::this_thread::yield();
+		}
+
+		const uint32_t index = m_chunk_count.load(std::memory_order_relaxed);
+		if(index == m_max_chunks)
+		{
+			printf("ERROR: concurrent pool ran out of handles\n");
+			return nullptr;
+		}
+
+		const uint32_t size = m_size << index;
+		const uint32_t first = m_size * ((1U << index) - 1);
+		Slot* chunk = static_cast<Slot*>(aligned_alloc(size * sizeof(Slot), alignof(Slot)));
+
+		for(uint32_t i = 0; i < size; ++i)
+		{
+			Slot& slot = chunk[i];
+			slot.m_handle = first + i;
+			slot.m_next = (i + 1) % BATCH != 0 ? &chunk[i + 1] : nullptr;
+			slot.m_next_batch = i % BATCH == 0 && i + BATCH < size ? &chunk[i + BATCH] : nullptr;
+			slot.m_last_batch = &chunk[size - BATCH];
+		}
+
+		m_chunks[index] = chunk;
+		m_chunk_count.store(index + 1, std::memory_order_release);
+
+		// the first batch goes to the caller
+		if(size > BATCH)
+		{
+			m_batches.fetch_add(int32_t(size / BATCH - 1));
+			m_free.push(&chunk[BATCH], &chunk[size - BATCH]);
+		}
+		return chunk;
+	}
+
+	template <class T>
+	typename ConcurrentSlots<T>::Slot* ConcurrentSlots<T>::pop()
+	{
+		Slot* batch = static_cast<Slot*>(m_free.pop_all());
+		if(!batch)
+			return nullptr;
+
+		// the other batches go back to the list in one exchange
+		if(Slot* first = batch->m_next_batch)
+		{
+			// batches that were pushed back skip to the end of the run they were pushed with
+			Slot* last = first;
+			while(true)
+			{
+				last = last->m_last_batch ? last->m_last_batch : last;
+				if(!last->m_next_batch)
+					break;
+				last = last->m_next_batch;
+			}
+
+			// so that the next walk skips the whole list
+			for(Slot* at = first; at != last;)
+			{
+				Slot* end = at->m_last_batch ? at->m_last_batch : at;
+				at->m_last_batch = last;
+				if(end == last)
+					break;
+				end->m_last_batch = last;
+				at = end->m_next_batch;
+			}
+			last->m_last_batch = last;
+
+			m_free.push(first, last);
+		}
+
+		m_batches.fetch_sub(1);
+		return batch;
+	}
+
+	template <class T>
+	void ConcurrentSlots<T>::push(Slot* batch)
+	{
+		batch->m_last_batch = nullptr;
+		m_batches.fetch_add(1);
+		m_free.push(batch);
+	}
+
+	template <class T>
+	typename ConcurrentSlots<T>::Slot* ConcurrentSlots<T>::take()
+	{
+		Slot* batch = this->pop();
+		return batch ? batch : this->grow();
+	}
+
+	template <class T>
+	T* ConcurrentSlots<T>::alloc()
+	{
+		const uint32_t thread = thread_index();
+		if(thread >= MAX_THREADS)
+		{
+			Slot* slot = this->take();
+			if(slot && slot->m_next)
+				this->push(slot->m_next);
+			return slot ? reinterpret_cast<T*>(slot->m_value) : nullptr;
+		}
+
+		Cache& cache = m_caches[thread];
+		if(!cache.m_head)
+		{
+			cache.m_head = this->take();
+			for(Slot* slot = cache.m_head; slot; slot = slot->m_next)
+				cache.m_count++;
+			if(!cache.m_head)
+				return nullptr;
+		}
+
+		Slot* slot = cache.m_head;
+		cache.m_head = slot->m_next;
+		cache.m_count--;
+		return reinterpret_cast<T*>(slot->m_value);
+	}
+
+	template <class T>
+	void ConcurrentSlots<T>::free(T* object)
+	{
+		Slot* slot = reinterpret_cast<Slot*>(object);
+
+		const uint32_t thread = thread_index();
+		if(thread >= MAX_THREADS)
+		{
+			slot->m_next = nullptr;
+			this->push(slot);
+			return;
+		}
+
+		Cache& cache = m_caches[thread];
+		slot->m_next = cache.m_head;
+		cache.m_head = slot;
+
+		// the least recently freed half of the cache goes back to the global list
+		if(++cache.m_count == 2 * BATCH)
+		{
+			Slot* last = cache.m_head;
+			for(uint32_t i = 1; i < BATCH; ++i)
+				last = last->m_next;
+			this->push(last->m_next);
+			last->m_next = nullptr;
+			cache.m_count = BATCH;
+		}
+	}
+
+	template <class T>
+	inline uint32_t ConcurrentSlots<T>::handle(T* object) const
+	{
+		return reinterpret_cast<Slot*>(object)->m_handle;
+	}
+
+	template <class T>
+	inline T& ConcurrentSlots<T>::get(uint32_t handle) const
+	{
+		// chunk c holds the handles from m_size * (2^c - 1) to m_size * (2^(c+1) - 1)
+		const uint32_t n = (handle / m_size) + 1;
+		const uint32_t chunk = 31 - stl::clz(n);
+		const uint32_t first = m_size * ((1U << chunk) - 1);
+		return *reinterpret_cast<T*>(m_chunks[chunk][handle - first].m_value);
+	}
+
+	template <class T>
+	size_t ConcurrentSlots<T>::capacity() const
+	{
+		return size_t(m_size) * ((size_t(1) << m_chunk_count.load(std::memory_order_relaxed)) - 1);
+	}
+
+	template <class T>
+	void ConcurrentSlots<T>::clear()
+	{
+		for(uint32_t i = 0; i < m_chunk_count; ++i)
+		{
+			aligned_free(m_chunks[i]);
+			m_chunks[i] = nullptr;
+		}
+		for(Cache& cache : m_caches)
+			cache = {};
+		m_free.pop_all();
+		m_batches = 0;
+		m_chunk_count = 0;
+	}
+
+	template <class T>
+	ConcurrentPool<T>::ConcurrentPool(uint32_t size) : m_slots(size) {}
+	template <class T>
+	ConcurrentPool<T>::~ConcurrentPool() {}
+
+	template <class T>
+	inline T* ConcurrentPool<T>::talloc() { return m_slots.alloc(); }
+	template <class T>
+	inline void ConcurrentPool<T>::tdestroy(T& object) { object.~T(); m_slots.free(&object); }
+	template <class T>
+	inline void ConcurrentPool<T>::tfree(T& object) { m_slots.free(&object); }
+
+	template <class T>
+	void ConcurrentPool<T>::alloc(Ref& ref) { setval<T>(ref, m_slots.alloc()); }
+	template <class T>
+	Ref ConcurrentPool<T>::alloc() { return Ref(m_slots.alloc(), type<T>()); }
+	template <class T>
+	void ConcurrentPool<T>::destroy(Ref object) { this->tdestroy(val<T>(object)); }
+	template <class T>
+	void ConcurrentPool<T>::free(Ref object) { m_slots.free(&val<T>(object)); }
+
+	template <class T>
+	void ConcurrentPool<T>::reset() { m_slots.clear(); }
+	template <class T>
+	void ConcurrentPool<T>::clear() { m_slots.clear(); }
+
+	template <class T>
+	template <class... Types>
+	inline T& ConcurrentPool<T>::construct(Types&&... args)
+	{
+		T* at = m_slots.alloc();
+		new (stl::placeholder(), at) T(static_cast<Types&&>(args)...);
+		return *at;
+	}
+
+	template <class T>
+	ConcurrentSparsePool<T>::ConcurrentSparsePool(uint32_t size) : m_slots(size) {}
+	template <class T>
+	ConcurrentSparsePool<T>::~ConcurrentSparsePool() {}
+
+	template <class T>
+	template <class... Types>
+	inline uint32_t ConcurrentSparsePool<T>::create(Types&&... args)
+	{
+		T* at = m_slots.alloc();
+		if(!at)
+			return UINT32_MAX;
+		new (stl::placeholder(), at) T(static_cast<Types&&>(args)...);
+		return m_slots.handle(at);
+	}
+
+	template <class T>
+	inline void ConcurrentSparsePool<T>::destroy(uint32_t handle)
+	{
+		T& object = m_slots.get(handle);
+		object.~T();
+		m_slots.free(&object);
+	}
+
+	template <class T>
+	inline T& ConcurrentSparsePool<T>::get(uint32_t handle) { return m_slots.get(handle); }
+
+	template <class T>
+	void ConcurrentSparsePool<T>::clear() { m_slots.clear(); }
+}
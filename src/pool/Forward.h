@@ -13,6 +13,9 @@ namespace mud
 {
 	template <class T> class VecPool;
 	template <class T> class TPool;
+	template <class T> class ConcurrentSlots;
+	template <class T> class ConcurrentPool;
+	template <class T> class ConcurrentSparsePool;
 
 	template <class T> struct SparseHandle;
 	template <class T> struct OwnedHandle;
@@ -47,6 +47,8 @@ namespace mud
 		virtual void destroy(Ref object);
 		virtual void free(Ref object);
 
+		void reserve(size_t count);
+
 		void reset(size_t size);
 		virtual void reset();
 		virtual void clear();
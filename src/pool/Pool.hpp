@@ -42,6 +42,9 @@ namespace mud
 	template <class T>
 	void TPool<T>::free(Ref object) { m_vec_pool->free(&val<T>(object)); }
 
+	template <class T>
+	inline void TPool<T>::reserve(size_t count) { m_vec_pool->reserve(count); }
+
 	template <class T>
 	inline void TPool<T>::reset(size_t size) { m_vec_pool = make_unique<VecPool<T>>(size); }
 	template <class T>
@@ -62,10 +65,8 @@ namespace mud
 	template <class T_Func>
 	inline void TPool<T>::iterate(T_Func func) const
 	{
-		VecPool<T>* pool = m_vec_pool.get();
-		for(; pool; pool = pool->m_next.get())
-			for(T* object : pool->m_objects)
-				func(*object);
+		if(m_vec_pool)
+			m_vec_pool->iterate(func);
 	}
 
 	template <class T>
@@ -50,7 +50,7 @@ namespace mud
 	template <class T>
 	struct DestroyHandle
 	{
-		static void destroy(const OwnedHandle<T>& handle) { UNUSED(handle); }
+		static void destroy(const SparseHandle<T>& handle) { UNUSED(handle); }
 	};
 
 	template <class T>
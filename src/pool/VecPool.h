@@ -7,8 +7,11 @@
 #include <stl/vector.h>
 #include <type/Unique.h>
 
+#include <stdint.h>
+
 namespace mud
 {
+	// objects are allocated in chunks, chained with a chunk twice as large when one is full
 	export_ template <class T>
 	class VecPool
 	{
@@ -20,6 +23,16 @@ namespace mud
 		void destroy(T* object);
 		void free(T* object);
 
+		// makes room for count objects in total, so that allocating them doesn't chain more than one chunk
+		void reserve(size_t count);
+
+		size_t capacity() const;
+		size_t count() const;
+
+		// visits the live objects of each chunk in address order
+		template <class T_Func>
+		void iterate(T_Func func) const;
+
 	public:
 		template <class... Types>
 		inline T& construct(Types&&... args);
@@ -28,6 +41,12 @@ namespace mud
 		size_t m_size;
 		vector<T*> m_available;
 		vector<T*> m_objects;
+
+		// index of each slot in m_objects, so that freeing swaps the last object in its place
+		vector<uint32_t> m_indices;
+		// one bit per slot, set when the slot holds a live object
+		vector<uint64_t> m_occupied;
+
 		void* m_chunk;
 		T* m_memory;
 		T* m_last;
@@ -5,6 +5,8 @@
 #pragma once
 
 #include <stl/algorithm.h>
+#include <stl/math.h>
+#include <stl/bitset.h>
 #include <pool/VecPool.h>
 #include <type/TypeUtils.h>
 
@@ -22,9 +24,12 @@ namespace mud
 
 		m_available.reserve(size);
 		m_objects.reserve(size);
+		m_indices.resize(size);
+		m_occupied.resize((size + 63) / 64, 0);
 
-		for(size_t i = 0; i < size; ++i)
-			m_available.push_back(&m_memory[i]);
+		// the first slots are handed out first
+		for(size_t i = size; i > 0; --i)
+			m_available.push_back(&m_memory[i - 1]);
 	}
 
 	template <class T>
@@ -47,6 +52,10 @@ namespace mud
 
 		T* object = m_available.back();
 		m_available.pop_back();
+
+		const size_t slot = object - m_memory;
+		m_occupied[slot / 64] |= 1ULL << (slot % 64);
+		m_indices[slot] = uint32_t(m_objects.size());
 		m_objects.push_back(object);
 		return object;
 	}
@@ -64,8 +73,49 @@ namespace mud
 		if(object < m_memory || object > m_last)
 			return m_next->free(object);
 
+		const size_t slot = object - m_memory;
+		m_occupied[slot / 64] &= ~(1ULL << (slot % 64));
 		m_available.push_back(object);
-		remove(m_objects, object);
+
+		const uint32_t index = m_indices[slot];
+		T* last = m_objects.back();
+		m_objects[index] = last;
+		m_indices[last - m_memory] = index;
+		m_objects.pop_back();
+	}
+
+	template <class T>
+	void VecPool<T>::reserve(size_t count)
+	{
+		VecPool<T>* pool = this;
+		size_t capacity = m_size;
+		for(; pool->m_next; pool = pool->m_next.get())
+			capacity += pool->m_next->m_size;
+
+		if(capacity < count)
+			pool->m_next = make_unique<VecPool<T>>(max(count - capacity, pool->m_size * 2));
+	}
+
+	template <class T>
+	size_t VecPool<T>::capacity() const
+	{
+		return m_size + (m_next ? m_next->capacity() : 0);
+	}
+
+	template <class T>
+	size_t VecPool<T>::count() const
+	{
+		return m_objects.size() + (m_next ? m_next->count() : 0);
+	}
+
+	template <class T>
+	template <class T_Func>
+	inline void VecPool<T>::iterate(T_Func func) const
+	{
+		for(const VecPool<T>* pool = this; pool; pool = pool->m_next.get())
+			for(size_t w = 0; w < pool->m_occupied.size(); ++w)
+				for(uint64_t bits = pool->m_occupied[w]; bits != 0; bits &= bits - 1)
+					func(pool->m_memory[w * 64 + stl::ctz(bits)]);
 	}
 
 	template <class T>
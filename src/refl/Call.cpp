@@ -36,8 +36,7 @@ namespace mud
 
 	Call::Call(const Callable& callable, vector<Var> args)
 		: m_callable(&callable)
-		, m_args(args)
-		, m_vargs(args.size(), nullptr)
+		, m_args(move(args))
 	{
 		if(!callable.m_return_type.isvoid())
 		{
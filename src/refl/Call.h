@@ -5,6 +5,7 @@
 #pragma once
 
 #include <stl/vector.h>
+#include <stl/small_vector.h>
 #include <type/Var.h>
 #include <refl/Forward.h>
 #include <refl/Method.h>
@@ -27,7 +28,8 @@ namespace mud
 
 		const Callable* m_callable = nullptr;
 		attr_ vector<Var> m_args;
-		attr_ vector<void*> m_vargs;
+		// pointers to the arguments, rebuilt by prepare() : kept inline since calls rarely have more than a few
+		small_vector<void*, 8> m_vargs;
 		attr_ Var m_result;
 	};
 }
@@ -185,6 +185,8 @@ namespace mud
 
 	void unpack(FromJson& unpacker, Ref value, const json& json_value)
 	{
+		alloc_scope tag(alloc_tag::srlz);
+
 		if(unpacker.check(value))
 		{
 			unpacker.dispatch(value, json_value);
@@ -286,6 +288,8 @@ namespace mud
 
 	void pack(ToJson& packer, const Var& value, json& json_value, bool typed)
 	{
+		alloc_scope tag(alloc_tag::srlz);
+
 		if(packer.check(value.m_ref))
 		{
 			packer.dispatch(value.m_ref, json_value);
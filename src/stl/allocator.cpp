@@ -0,0 +1,198 @@
+#include <stl/allocator.h>
+
+#include <new>
+#include <atomic>
+
+namespace stl {
+
+	namespace
+	{
+		// in front of each block : keeps the data aligned like operator new does, and tells deallocate what to account the block to
+		struct alignas(16) alloc_header {
+			const alloc_backend* m_backend;
+			uint64_t m_size : 56;
+			uint64_t m_tag : 8;
+		};
+
+		static_assert(sizeof(alloc_header) == 16, "allocation header must keep blocks 16 bytes aligned");
+
+		constexpr size_t tags = size_t(alloc_tag::count);
+
+		// # of threads with their own counters, the others share the last slot
+		constexpr size_t alloc_threads = 128;
+
+		// counters of a thread : only that thread writes them, without atomic read-modify-writes, and readers sum all the slots
+		// a block freed by another thread is subtracted from the slot of that thread, so a single slot can go negative but the sum can't
+		struct alignas(64) alloc_counters {
+			std::atomic<int64_t> m_bytes[tags];
+			std::atomic<int64_t> m_allocations[tags];
+			std::atomic<uint64_t> m_total_bytes[tags];
+			std::atomic<uint64_t> m_total_allocations[tags];
+			std::atomic<bool> m_used;
+		};
+
+		// two histograms per tag : the one being filled, and the one of the last frame
+		struct alloc_histograms {
+			std::atomic<uint32_t> m_counts[2][alloc_buckets];
+		};
+
+		void* default_allocate(size_t bytes) { return operator new(bytes); }
+		void default_deallocate(void* ptr, size_t bytes) { (void)bytes; operator delete(ptr); }
+
+		constexpr alloc_backend s_default_backend = { default_allocate, default_deallocate };
+
+		// all of these are constant initialized, so allocations made during static initialization are accounted too
+		std::atomic<const alloc_backend*> s_backend = { &s_default_backend };
+		std::atomic<bool> s_histograms_enabled = { false };
+		std::atomic<uint32_t> s_frame = { 0 };
+		alloc_counters s_counters[alloc_threads + 1];
+		alloc_histograms s_histograms[tags];
+
+		alloc_counters& s_shared = s_counters[alloc_threads];
+
+		thread_local alloc_tag t_tag = alloc_tag::untagged;
+		thread_local alloc_counters* t_counters = nullptr;
+
+		// the slot of a thread that exits is given to the next one, with its counts, which keeps the sums right
+		// blocks allocated by a thread after its slot is released, from thread_local destructors, go to the shared slot
+		struct alloc_thread {
+			alloc_thread() {
+				for(size_t i = 0; i < alloc_threads; ++i) {
+					bool used = false;
+					if(!s_counters[i].m_used.load(std::memory_order_relaxed) && s_counters[i].m_used.compare_exchange_strong(used, true, std::memory_order_acquire)) {
+						m_counters = &s_counters[i];
+						return;
+					}
+				}
+				m_counters = &s_shared;
+			}
+
+			~alloc_thread() {
+				t_counters = &s_shared;
+				if(m_counters != &s_shared)
+					m_counters->m_used.store(false, std::memory_order_release);
+			}
+
+			alloc_counters* m_counters;
+		};
+
+		alloc_counters& thread_counters() {
+			if(!t_counters) {
+				thread_local alloc_thread thread;
+				t_counters = thread.m_counters;
+			}
+			return *t_counters;
+		}
+
+		template <class T>
+		inline void count(alloc_counters& counters, std::atomic<T>& counter, T value) {
+			if(&counters == &s_shared)
+				counter.fetch_add(value, std::memory_order_relaxed);
+			else
+				counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+		}
+
+		uint32_t alloc_bucket(size_t bytes) {
+			uint32_t bucket = 0;
+			while(bytes > 1 && bucket < alloc_buckets - 1) {
+				bytes >>= 1;
+				++bucket;
+			}
+			return bucket;
+		}
+	}
+
+	void set_alloc_backend(const alloc_backend* backend) {
+		s_backend.store(backend ? backend : &s_default_backend, std::memory_order_release);
+	}
+
+	alloc_tag set_alloc_tag(alloc_tag tag) {
+		const alloc_tag previous = t_tag;
+		t_tag = tag;
+		return previous;
+	}
+
+	alloc_tag current_alloc_tag() {
+		return t_tag;
+	}
+
+	const char* alloc_tag_name(alloc_tag tag) {
+		static const char* names[] = { "untagged", "infra", "ecs", "gfx", "ui", "lang", "srlz", "app" };
+		static_assert(sizeof(names) / sizeof(names[0]) == tags, "alloc_tag names don't match the tags");
+		return size_t(tag) < tags ? names[size_t(tag)] : "";
+	}
+
+	alloc_stats alloc_tag_stats(alloc_tag tag) {
+		const size_t t = size_t(tag);
+		int64_t bytes = 0;
+		int64_t allocations = 0;
+		alloc_stats stats = {};
+		for(const alloc_counters& counters : s_counters) {
+			bytes += counters.m_bytes[t].load(std::memory_order_relaxed);
+			allocations += counters.m_allocations[t].load(std::memory_order_relaxed);
+			stats.m_total_bytes += counters.m_total_bytes[t].load(std::memory_order_relaxed);
+			stats.m_total_allocations += counters.m_total_allocations[t].load(std::memory_order_relaxed);
+		}
+		// slots are read one after the other, so a free can be seen without its allocation
+		stats.m_bytes = bytes > 0 ? uint64_t(bytes) : 0;
+		stats.m_allocations = allocations > 0 ? uint64_t(allocations) : 0;
+		return stats;
+	}
+
+	void enable_alloc_histograms(bool enabled) {
+		s_histograms_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void next_alloc_frame() {
+		// the closed histogram becomes the last frame, and the previous last frame is cleared to be filled next
+		const uint32_t closed = s_frame.load(std::memory_order_relaxed);
+		for(alloc_histograms& histograms : s_histograms)
+			for(std::atomic<uint32_t>& count : histograms.m_counts[closed ^ 1])
+				count.store(0, std::memory_order_relaxed);
+		s_frame.store(closed ^ 1, std::memory_order_relaxed);
+	}
+
+	alloc_histogram alloc_frame_histogram(alloc_tag tag) {
+		const uint32_t last = s_frame.load(std::memory_order_relaxed) ^ 1;
+		alloc_histogram histogram;
+		for(size_t i = 0; i < alloc_buckets; ++i)
+			histogram.m_counts[i] = s_histograms[size_t(tag)].m_counts[last][i].load(std::memory_order_relaxed);
+		return histogram;
+	}
+
+	void* tagged_allocate(size_t bytes) {
+		const alloc_backend* backend = s_backend.load(std::memory_order_acquire);
+		alloc_header* header = static_cast<alloc_header*>(backend->m_allocate(sizeof(alloc_header) + bytes));
+		header->m_backend = backend;
+		header->m_size = bytes;
+		const size_t tag = size_t(t_tag);
+		header->m_tag = uint8_t(tag);
+
+		alloc_counters& counters = thread_counters();
+		count(counters, counters.m_bytes[tag], int64_t(bytes));
+		count(counters, counters.m_allocations[tag], int64_t(1));
+		count(counters, counters.m_total_bytes[tag], uint64_t(bytes));
+		count(counters, counters.m_total_allocations[tag], uint64_t(1));
+
+		if(s_histograms_enabled.load(std::memory_order_relaxed)) {
+			const uint32_t frame = s_frame.load(std::memory_order_relaxed);
+			s_histograms[tag].m_counts[frame][alloc_bucket(bytes)].fetch_add(1, std::memory_order_relaxed);
+		}
+
+		return header + 1;
+	}
+
+	void tagged_deallocate(void* ptr) {
+		if(!ptr)
+			return;
+
+		alloc_header* header = static_cast<alloc_header*>(ptr) - 1;
+		const size_t bytes = size_t(header->m_size);
+
+		alloc_counters& counters = thread_counters();
+		count(counters, counters.m_bytes[header->m_tag], -int64_t(bytes));
+		count(counters, counters.m_allocations[header->m_tag], int64_t(-1));
+
+		header->m_backend->m_deallocate(header, sizeof(alloc_header) + bytes);
+	}
+}
@@ -1,16 +1,90 @@
 #pragma once
 
+#include <infra/Config.h>
+
 #include <stl/stddef.h>
+#include <stdint.h>
 
 namespace stl {
 
+	// the subsystem an allocation is accounted to : it's set for the calling thread by an alloc_scope
+	enum class alloc_tag : uint8_t {
+		untagged,
+		infra,
+		ecs,
+		gfx,
+		ui,
+		lang,
+		srlz,
+		app,
+		count
+	};
+
+	// # of buckets of the allocation histograms : bucket i counts the allocations of 2^i up to 2^(i+1) - 1 bytes
+	constexpr size_t alloc_buckets = 32;
+
+	struct alloc_stats {
+		uint64_t m_bytes;              // bytes currently allocated
+		uint64_t m_allocations;        // blocks currently allocated
+		uint64_t m_total_bytes;        // bytes allocated since startup
+		uint64_t m_total_allocations;  // blocks allocated since startup
+	};
+
+	struct alloc_histogram {
+		uint32_t m_counts[alloc_buckets];
+	};
+
+	// where allocations get their memory from, operator new and delete unless another backend is set
+	// each block remembers the backend that allocated it, so a backend must outlive all of its blocks but it can be replaced at any time
+	struct alloc_backend {
+		void* (*m_allocate)(size_t bytes);
+		void (*m_deallocate)(void* ptr, size_t bytes);
+	};
+
+	MUD_INFRA_EXPORT void set_alloc_backend(const alloc_backend* backend);
+
+	// sets the tag of the calling thread, and returns the previous one
+	MUD_INFRA_EXPORT alloc_tag set_alloc_tag(alloc_tag tag);
+	MUD_INFRA_EXPORT alloc_tag current_alloc_tag();
+	MUD_INFRA_EXPORT const char* alloc_tag_name(alloc_tag tag);
+
+	// each thread counts in its own slot, and the slots are summed here : they can be read at any time from any thread
+	MUD_INFRA_EXPORT alloc_stats alloc_tag_stats(alloc_tag tag);
+
+	// histograms of the allocation sizes of each tag, over the last complete frame : next_alloc_frame() closes the current one
+	MUD_INFRA_EXPORT void enable_alloc_histograms(bool enabled);
+	MUD_INFRA_EXPORT void next_alloc_frame();
+	MUD_INFRA_EXPORT alloc_histogram alloc_frame_histogram(alloc_tag tag);
+
+	MUD_INFRA_EXPORT void* tagged_allocate(size_t bytes);
+	MUD_INFRA_EXPORT void tagged_deallocate(void* ptr);
+
+	struct alloc_scope {
+		explicit alloc_scope(alloc_tag tag) : m_previous(set_alloc_tag(tag)) {}
+		~alloc_scope() { set_alloc_tag(m_previous); }
+		alloc_scope(const alloc_scope&) = delete;
+		alloc_scope& operator=(const alloc_scope&) = delete;
+
+		alloc_tag m_previous;
+	};
+
+	// instrumented builds define MUD_ALLOC_TAGS (--profile) to tag, count, and give blocks to the backend
+	// the others go straight to operator new and delete, without a header in front of each block
 	struct allocator {
 		static void* static_allocate(size_t bytes) {
+#ifdef MUD_ALLOC_TAGS
+			return tagged_allocate(bytes);
+#else
 			return operator new(bytes);
+#endif
 		}
 
 		static void static_deallocate(void* ptr, size_t /*bytes*/) {
+#ifdef MUD_ALLOC_TAGS
+			tagged_deallocate(ptr);
+#else
 			operator delete(ptr);
+#endif
 		}
 	};
 }
@@ -18,3 +92,9 @@ namespace stl {
 #ifndef TINYSTL_ALLOCATOR
 #	define TINYSTL_ALLOCATOR ::stl::allocator
 #endif
+
+namespace mud
+{
+	using stl::alloc_tag;
+	using stl::alloc_scope;
+}
@@ -40,16 +40,20 @@ namespace stl
 	{
 		static_assert(sizeof(T) <= sizeof(uint64_t), "ctz() only support up to 64 bits");
 		T c = sizeof(T) * 8;
-		x &= -signed(x);
+		x &= T(0) - x;
 		if(x) c--;
 		if(sizeof(T) * 8 > 32) { // if() only needed to quash compiler warnings
-			if(x & 0x00000000FFFFFFFF) c -= 32;
+			if(x & T(0x00000000FFFFFFFF)) c -= 32;
 		}
-		if(x & 0x0000FFFF) c -= 16;
-		if(x & 0x00FF00FF) c -= 8;
-		if(x & 0x0F0F0F0F) c -= 4;
-		if(x & 0x33333333) c -= 2;
-		if(x & 0x55555555) c -= 1;
+		if(sizeof(T) * 8 > 16) {
+			if(x & T(0x0000FFFF0000FFFF)) c -= 16;
+		}
+		if(sizeof(T) * 8 > 8) {
+			if(x & T(0x00FF00FF00FF00FF)) c -= 8;
+		}
+		if(x & T(0x0F0F0F0F0F0F0F0F)) c -= 4;
+		if(x & T(0x3333333333333333)) c -= 2;
+		if(x & T(0x5555555555555555)) c -= 1;
 		return c;
 	}
 
@@ -190,6 +194,15 @@ namespace stl
 		friend bitset operator^(const bitset& lhs, const bitset& rhs) { return bitset(lhs) ^= rhs; }
 	};
 
+	template <class T, size_t N>
+	inline size_t hash(const bitset<T, N>& value)
+	{
+		size_t hash = 0;
+		for(size_t i = 0; i < N; ++i)
+			hash = hash * 31 + size_t(value.at(i));
+		return hash;
+	}
+
 	using bitset8 = bitset<uint8_t>;
 	using bitset32 = bitset<uint32_t>;
 	using bitset256 = bitset<uint64_t, 4>;
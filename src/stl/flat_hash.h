@@ -0,0 +1,194 @@
+#pragma once
+
+#ifdef USE_STL
+#else
+#include <stl/allocator.h>
+#include <stl/hash.h>
+#include <stl/hash_base.h>
+#include <stdint.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#define STL_FLAT_HASH_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace stl {
+
+	// each slot has a control byte : the 7 low bits of the hash of its key when it's full, or one of these
+	enum flat_ctrl : int8_t {
+		flat_empty = -128,
+		flat_deleted = -2,
+		flat_sentinel = -1,
+	};
+
+	inline uint32_t flat_ctz(uint64_t x) {
+#if defined _MSC_VER
+		unsigned long index; _BitScanForward64(&index, x); return uint32_t(index);
+#else
+		return uint32_t(__builtin_ctzll(x));
+#endif
+	}
+
+	inline uint32_t flat_clz(uint64_t x) {
+#if defined _MSC_VER
+		unsigned long index; _BitScanReverse64(&index, x); return 63 - uint32_t(index);
+#else
+		return uint32_t(__builtin_clzll(x));
+#endif
+	}
+
+	// spreads weak hashes, like those of integers, over the whole word, so that both the position and the control byte are well distributed
+	inline size_t flat_mix(size_t hash) {
+		const uint64_t h = uint64_t(hash) * 0x9E3779B97F4A7C15ULL;
+		return size_t(h ^ (h >> 32));
+	}
+
+	// a group of control bytes, probed all at once
+	// with SSE2 a group is 16 bytes compared in a few instructions, otherwise 8 bytes packed in a word
+	struct flat_group {
+#ifdef STL_FLAT_HASH_SSE2
+		static constexpr size_t width = 16;
+		static constexpr uint32_t shift = 0;
+		static constexpr uint32_t bits = 16;
+
+		explicit flat_group(const int8_t* ctrl) : m_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+		uint64_t match(int8_t h2) const { return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), m_ctrl))); }
+		uint64_t match_empty() const { return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(flat_empty), m_ctrl))); }
+		uint64_t match_free() const { return uint32_t(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(flat_sentinel), m_ctrl))); }
+
+		__m128i m_ctrl;
+#else
+		static constexpr size_t width = 8;
+		static constexpr uint32_t shift = 3;
+		static constexpr uint32_t bits = 64;
+		static constexpr uint64_t lsbs = 0x0101010101010101ULL;
+		static constexpr uint64_t msbs = 0x8080808080808080ULL;
+
+		explicit flat_group(const int8_t* ctrl) : m_ctrl(0) {
+			for(size_t i = 0; i < width; ++i)
+				m_ctrl |= uint64_t(uint8_t(ctrl[i])) << (i * 8);
+		}
+
+		// might match a full slot right after a matching one, which is fine since keys are compared anyway
+		uint64_t match(int8_t h2) const { const uint64_t x = m_ctrl ^ (lsbs * uint8_t(h2)); return (x - lsbs) & ~x & msbs; }
+		uint64_t match_empty() const { return (m_ctrl & (~m_ctrl << 6)) & msbs; }
+		uint64_t match_free() const { return (m_ctrl & (~m_ctrl << 7)) & msbs; }
+
+		uint64_t m_ctrl;
+#endif
+		// index of the first slot in a mask, and the number of slots after the last one
+		static uint32_t first(uint64_t mask) { return flat_ctz(mask) >> shift; }
+		static uint32_t after_last(uint64_t mask) { return (flat_clz(mask) - (64 - bits)) >> shift; }
+	};
+
+	// control bytes of the tables that have no slots yet : lookups find an empty slot right away, without allocating
+	inline int8_t* flat_empty_group() {
+		alignas(16) static const int8_t group[16] = { flat_sentinel, flat_empty, flat_empty, flat_empty, flat_empty, flat_empty, flat_empty, flat_empty,
+													  flat_empty, flat_empty, flat_empty, flat_empty, flat_empty, flat_empty, flat_empty, flat_empty };
+		return const_cast<int8_t*>(group);
+	}
+
+	template <class Key>
+	inline const Key& flat_key(const Key& key) { return key; }
+
+	template <class Key, class Value>
+	inline const Key& flat_key(const pair<Key, Value>& slot) { return slot.first; }
+
+	template <class Slot>
+	struct flat_iterator {
+		flat_iterator() {}
+		flat_iterator(const int8_t* ctrl, Slot* slot) : m_ctrl(ctrl), m_slot(slot) {}
+		template <class T>
+		flat_iterator(const flat_iterator<T>& other) : m_ctrl(other.m_ctrl), m_slot(other.m_slot) {}
+
+		Slot* operator->() const { return m_slot; }
+		Slot& operator*() const { return *m_slot; }
+
+		flat_iterator& operator++() { ++m_ctrl; ++m_slot; this->skip(); return *this; }
+
+		// free slots are skipped up to the sentinel that follows the last slot
+		void skip() { while(*m_ctrl < flat_sentinel) { ++m_ctrl; ++m_slot; } }
+
+		const int8_t* m_ctrl;
+		Slot* m_slot;
+	};
+
+	template <class LSlot, class RSlot>
+	static inline bool operator==(const flat_iterator<LSlot>& lhs, const flat_iterator<RSlot>& rhs) {
+		return lhs.m_ctrl == rhs.m_ctrl;
+	}
+
+	template <class LSlot, class RSlot>
+	static inline bool operator!=(const flat_iterator<LSlot>& lhs, const flat_iterator<RSlot>& rhs) {
+		return lhs.m_ctrl != rhs.m_ctrl;
+	}
+
+	// open addressing hash table, in the layout of the swiss tables : slots are stored inline, with one control byte each
+	// a lookup probes a whole group of control bytes at once for the 7 bits of the hash, and only compares the keys of the slots that match
+	// slots move when the table grows, so pointers to them are only valid until the next insertion
+	//
+	// the capacity is a power of two minus one, the control bytes are followed by a sentinel, and by a copy of the first group so that groups can be loaded at any slot
+	template <class Key, class Slot, class Alloc = TINYSTL_ALLOCATOR>
+	class flat_table {
+	public:
+		flat_table();
+		flat_table(const flat_table& other);
+		flat_table(flat_table&& other);
+		~flat_table();
+
+		flat_table& operator=(const flat_table& other);
+		flat_table& operator=(flat_table&& other);
+
+		using iterator = flat_iterator<Slot>;
+		using const_iterator = flat_iterator<const Slot>;
+
+		iterator begin();
+		iterator end();
+
+		const_iterator begin() const;
+		const_iterator end() const;
+
+		void clear();
+		bool empty() const;
+		size_t size() const;
+		size_t capacity() const;
+
+		// makes room for count slots without growing
+		void reserve(size_t count);
+
+		iterator find(const Key& key);
+		const_iterator find(const Key& key) const;
+
+		void erase(const_iterator where);
+		size_t erase(const Key& key);
+
+		void swap(flat_table& other);
+
+	protected:
+		// index of the slot holding the key, or of a free slot reserved for it : second is true when the slot must be constructed
+		pair<size_t, bool> prepare(const Key& key);
+
+		size_t lookup(const Key& key, size_t hash) const;
+		size_t find_free(size_t hash) const;
+		void set_ctrl(size_t index, int8_t ctrl);
+		void rehash(size_t capacity);
+		void release();
+
+		static size_t growth(size_t capacity) { return capacity - capacity / 8; }
+		static size_t slots_offset(size_t capacity) { return (capacity + flat_group::width + alignof(Slot) - 1) & ~(alignof(Slot) - 1); }
+		static size_t alloc_size(size_t capacity) { return slots_offset(capacity) + capacity * sizeof(Slot); }
+
+		int8_t* m_ctrl;
+		Slot* m_slots;
+		size_t m_size;
+		size_t m_capacity;
+		// # of empty slots that can still be filled before the table must grow
+		size_t m_growth;
+	};
+}
+#endif
@@ -0,0 +1,289 @@
+#pragma once
+
+#ifdef USE_STL
+#else
+#include <stl/new.h>
+#include <stl/flat_hash.h>
+#include <stl/hash_base.hpp>
+
+#include <string.h>
+
+namespace stl {
+
+	template <class Key, class Slot, class Alloc>
+	inline flat_table<Key, Slot, Alloc>::flat_table()
+		: m_ctrl(flat_empty_group())
+		, m_slots(nullptr)
+		, m_size(0)
+		, m_capacity(0)
+		, m_growth(0)
+	{}
+
+	template <class Key, class Slot, class Alloc>
+	inline flat_table<Key, Slot, Alloc>::flat_table(const flat_table& other)
+		: flat_table()
+	{
+		if(other.m_size == 0)
+			return;
+
+		char* memory = static_cast<char*>(Alloc::static_allocate(alloc_size(other.m_capacity)));
+		m_ctrl = reinterpret_cast<int8_t*>(memory);
+		m_slots = reinterpret_cast<Slot*>(memory + slots_offset(other.m_capacity));
+		m_capacity = other.m_capacity;
+		m_size = other.m_size;
+		m_growth = other.m_growth;
+
+		memcpy(m_ctrl, other.m_ctrl, m_capacity + flat_group::width);
+		for(size_t i = 0; i < m_capacity; ++i)
+			if(m_ctrl[i] >= 0)
+				new(placeholder(), &m_slots[i]) Slot(other.m_slots[i]);
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline flat_table<Key, Slot, Alloc>::flat_table(flat_table&& other)
+		: flat_table()
+	{
+		this->swap(other);
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline flat_table<Key, Slot, Alloc>::~flat_table() {
+		this->release();
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline flat_table<Key, Slot, Alloc>& flat_table<Key, Slot, Alloc>::operator=(const flat_table& other) {
+		flat_table(other).swap(*this);
+		return *this;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline flat_table<Key, Slot, Alloc>& flat_table<Key, Slot, Alloc>::operator=(flat_table&& other) {
+		flat_table(static_cast<flat_table&&>(other)).swap(*this);
+		return *this;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline void flat_table<Key, Slot, Alloc>::release() {
+		if(m_capacity == 0)
+			return;
+
+		for(size_t i = 0; i < m_capacity; ++i)
+			if(m_ctrl[i] >= 0)
+				m_slots[i].~Slot();
+		Alloc::static_deallocate(m_ctrl, alloc_size(m_capacity));
+
+		m_ctrl = flat_empty_group();
+		m_slots = nullptr;
+		m_size = m_capacity = m_growth = 0;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline typename flat_table<Key, Slot, Alloc>::iterator flat_table<Key, Slot, Alloc>::begin() {
+		iterator it = { m_ctrl, m_slots };
+		it.skip();
+		return it;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline typename flat_table<Key, Slot, Alloc>::iterator flat_table<Key, Slot, Alloc>::end() {
+		return { m_ctrl + m_capacity, m_slots + m_capacity };
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline typename flat_table<Key, Slot, Alloc>::const_iterator flat_table<Key, Slot, Alloc>::begin() const {
+		const_iterator it = { m_ctrl, m_slots };
+		it.skip();
+		return it;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline typename flat_table<Key, Slot, Alloc>::const_iterator flat_table<Key, Slot, Alloc>::end() const {
+		return { m_ctrl + m_capacity, m_slots + m_capacity };
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline void flat_table<Key, Slot, Alloc>::clear() {
+		if(m_capacity == 0)
+			return;
+
+		for(size_t i = 0; i < m_capacity; ++i)
+			if(m_ctrl[i] >= 0)
+				m_slots[i].~Slot();
+
+		// the slots are kept for the next insertions
+		memset(m_ctrl, flat_empty, m_capacity + flat_group::width);
+		m_ctrl[m_capacity] = flat_sentinel;
+		m_size = 0;
+		m_growth = growth(m_capacity);
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline bool flat_table<Key, Slot, Alloc>::empty() const {
+		return m_size == 0;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline size_t flat_table<Key, Slot, Alloc>::size() const {
+		return m_size;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline size_t flat_table<Key, Slot, Alloc>::capacity() const {
+		return m_capacity;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline void flat_table<Key, Slot, Alloc>::reserve(size_t count) {
+		if(count <= m_size + m_growth)
+			return;
+
+		size_t capacity = flat_group::width * 2 - 1;
+		while(growth(capacity) < count)
+			capacity = capacity * 2 + 1;
+		this->rehash(capacity);
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline size_t flat_table<Key, Slot, Alloc>::lookup(const Key& key, size_t hash) const {
+		const int8_t h2 = int8_t(hash & 0x7F);
+		size_t position = (hash >> 7) & m_capacity;
+		size_t step = 0;
+		while(true) {
+			const flat_group group(m_ctrl + position);
+			for(uint64_t mask = group.match(h2); mask; mask &= mask - 1) {
+				const size_t index = (position + flat_group::first(mask)) & m_capacity;
+				if(flat_key<Key>(m_slots[index]) == key)
+					return index;
+			}
+			// an empty slot ends the probe : the key would have been inserted there
+			if(group.match_empty())
+				return SIZE_MAX;
+			step += flat_group::width;
+			position = (position + step) & m_capacity;
+		}
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline size_t flat_table<Key, Slot, Alloc>::find_free(size_t hash) const {
+		size_t position = (hash >> 7) & m_capacity;
+		size_t step = 0;
+		while(true) {
+			const uint64_t mask = flat_group(m_ctrl + position).match_free();
+			if(mask)
+				return (position + flat_group::first(mask)) & m_capacity;
+			step += flat_group::width;
+			position = (position + step) & m_capacity;
+		}
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline void flat_table<Key, Slot, Alloc>::set_ctrl(size_t index, int8_t ctrl) {
+		// the first width - 1 control bytes are mirrored after the sentinel
+		m_ctrl[index] = ctrl;
+		m_ctrl[((index - (flat_group::width - 1)) & m_capacity) + (flat_group::width - 1)] = ctrl;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline typename flat_table<Key, Slot, Alloc>::iterator flat_table<Key, Slot, Alloc>::find(const Key& key) {
+		const size_t index = this->lookup(key, flat_mix(hash(key)));
+		return index == SIZE_MAX ? this->end() : iterator(m_ctrl + index, m_slots + index);
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline typename flat_table<Key, Slot, Alloc>::const_iterator flat_table<Key, Slot, Alloc>::find(const Key& key) const {
+		const size_t index = this->lookup(key, flat_mix(hash(key)));
+		return index == SIZE_MAX ? this->end() : const_iterator(m_ctrl + index, m_slots + index);
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline pair<size_t, bool> flat_table<Key, Slot, Alloc>::prepare(const Key& key) {
+		const size_t keyhash = flat_mix(hash(key));
+		const size_t found = this->lookup(key, keyhash);
+		if(found != SIZE_MAX)
+			return pair<size_t, bool>(found, false);
+
+		size_t index = this->find_free(keyhash);
+		if(m_growth == 0 && m_ctrl[index] != flat_deleted) {
+			// when deleted slots take most of the table, it's rehashed at the same size to clear them
+			if(m_capacity == 0)
+				this->rehash(flat_group::width * 2 - 1);
+			else if(m_size * 32 <= m_capacity * 25)
+				this->rehash(m_capacity);
+			else
+				this->rehash(m_capacity * 2 + 1);
+			index = this->find_free(keyhash);
+		}
+
+		if(m_ctrl[index] == flat_empty)
+			--m_growth;
+		++m_size;
+		this->set_ctrl(index, int8_t(keyhash & 0x7F));
+		return pair<size_t, bool>(index, true);
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline void flat_table<Key, Slot, Alloc>::rehash(size_t capacity) {
+		int8_t* const ctrl = m_ctrl;
+		Slot* const slots = m_slots;
+		const size_t previous = m_capacity;
+
+		char* memory = static_cast<char*>(Alloc::static_allocate(alloc_size(capacity)));
+		m_ctrl = reinterpret_cast<int8_t*>(memory);
+		m_slots = reinterpret_cast<Slot*>(memory + slots_offset(capacity));
+		m_capacity = capacity;
+		m_growth = growth(capacity) - m_size;
+
+		memset(m_ctrl, flat_empty, capacity + flat_group::width);
+		m_ctrl[capacity] = flat_sentinel;
+
+		for(size_t i = 0; i < previous; ++i)
+			if(ctrl[i] >= 0) {
+				const size_t keyhash = flat_mix(hash(flat_key<Key>(slots[i])));
+				const size_t index = this->find_free(keyhash);
+				this->set_ctrl(index, ctrl[i]);
+				new(placeholder(), &m_slots[index]) Slot(static_cast<Slot&&>(slots[i]));
+				slots[i].~Slot();
+			}
+
+		if(previous > 0)
+			Alloc::static_deallocate(ctrl, alloc_size(previous));
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline void flat_table<Key, Slot, Alloc>::erase(const_iterator where) {
+		const size_t index = size_t(where.m_ctrl - m_ctrl);
+		m_slots[index].~Slot();
+		--m_size;
+
+		// the slot can go back to empty only if no probe ever went past it : the groups around it must have always had an empty slot
+		const size_t before = (index - flat_group::width) & m_capacity;
+		const uint64_t empty_after = flat_group(m_ctrl + index).match_empty();
+		const uint64_t empty_before = flat_group(m_ctrl + before).match_empty();
+		const bool never_full = empty_before && empty_after
+							 && flat_group::first(empty_after) + flat_group::after_last(empty_before) < flat_group::width;
+
+		this->set_ctrl(index, never_full ? flat_empty : flat_deleted);
+		if(never_full)
+			++m_growth;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline size_t flat_table<Key, Slot, Alloc>::erase(const Key& key) {
+		const_iterator where = this->find(key);
+		if(where == this->end())
+			return 0;
+		this->erase(where);
+		return 1;
+	}
+
+	template <class Key, class Slot, class Alloc>
+	inline void flat_table<Key, Slot, Alloc>::swap(flat_table& other) {
+		int8_t* ctrl = m_ctrl; m_ctrl = other.m_ctrl; other.m_ctrl = ctrl;
+		Slot* slots = m_slots; m_slots = other.m_slots; other.m_slots = slots;
+		size_t size = m_size; m_size = other.m_size; other.m_size = size;
+		size_t capacity = m_capacity; m_capacity = other.m_capacity; other.m_capacity = capacity;
+		size_t left = m_growth; m_growth = other.m_growth; other.m_growth = left;
+	}
+}
+#endif
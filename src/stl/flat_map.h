@@ -0,0 +1,35 @@
+#pragma once
+
+#ifdef USE_STL
+#include <unordered_map>
+namespace stl
+{
+	template <class Key, class Value>
+	using flat_map = std::unordered_map<Key, Value>;
+}
+#else
+#include <stl/flat_hash.h>
+
+namespace stl {
+
+	// map over a flat_table : unlike unordered_map, inserting moves the values when the table grows
+	template <class Key, class Value, class Alloc = TINYSTL_ALLOCATOR>
+	class flat_map : public flat_table<Key, pair<Key, Value>, Alloc> {
+	public:
+		using value_type = pair<Key, Value>;
+		using iterator = flat_iterator<value_type>;
+		using const_iterator = flat_iterator<const value_type>;
+
+		pair<iterator, bool> insert(const pair<Key, Value>& p);
+		pair<iterator, bool> insert(pair<Key, Value>&& p);
+		pair<iterator, bool> emplace(pair<Key, Value>&& p);
+
+		Value& operator[](const Key& key);
+	};
+}
+#endif
+
+namespace mud
+{
+	using stl::flat_map;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#ifdef USE_STL
+#include <unordered_map>
+#else
+#include <stl/flat_map.h>
+#include <stl/flat_hash.hpp>
+
+namespace stl {
+
+	template <class Key, class Value, class Alloc>
+	inline pair<typename flat_map<Key, Value, Alloc>::iterator, bool> flat_map<Key, Value, Alloc>::insert(const pair<Key, Value>& p) {
+		const pair<size_t, bool> slot = this->prepare(p.first);
+		if(slot.second)
+			new(placeholder(), &this->m_slots[slot.first]) value_type(p);
+		return pair<iterator, bool>(iterator(this->m_ctrl + slot.first, this->m_slots + slot.first), slot.second);
+	}
+
+	template <class Key, class Value, class Alloc>
+	inline pair<typename flat_map<Key, Value, Alloc>::iterator, bool> flat_map<Key, Value, Alloc>::insert(pair<Key, Value>&& p) {
+		const pair<size_t, bool> slot = this->prepare(p.first);
+		if(slot.second)
+			new(placeholder(), &this->m_slots[slot.first]) value_type(static_cast<value_type&&>(p));
+		return pair<iterator, bool>(iterator(this->m_ctrl + slot.first, this->m_slots + slot.first), slot.second);
+	}
+
+	template <class Key, class Value, class Alloc>
+	inline pair<typename flat_map<Key, Value, Alloc>::iterator, bool> flat_map<Key, Value, Alloc>::emplace(pair<Key, Value>&& p) {
+		return this->insert(static_cast<pair<Key, Value>&&>(p));
+	}
+
+	template <class Key, class Value, class Alloc>
+	inline Value& flat_map<Key, Value, Alloc>::operator[](const Key& key) {
+		const pair<size_t, bool> slot = this->prepare(key);
+		if(slot.second)
+			new(placeholder(), &this->m_slots[slot.first]) value_type(key, Value());
+		return this->m_slots[slot.first].second;
+	}
+}
+#endif
@@ -0,0 +1,36 @@
+#pragma once
+
+#ifdef USE_STL
+#include <unordered_set>
+namespace stl
+{
+	template <class Key>
+	using flat_set = std::unordered_set<Key>;
+}
+#else
+#include <stl/flat_hash.h>
+
+namespace stl {
+
+	// set over a flat_table : unlike unordered_set, inserting moves the keys when the table grows
+	template <class Key, class Alloc = TINYSTL_ALLOCATOR>
+	class flat_set : public flat_table<Key, Key, Alloc> {
+	public:
+		using iterator = flat_iterator<const Key>;
+		using const_iterator = iterator;
+
+		iterator begin() const { return flat_table<Key, Key, Alloc>::begin(); }
+		iterator end() const { return flat_table<Key, Key, Alloc>::end(); }
+
+		iterator find(const Key& key) const { return flat_table<Key, Key, Alloc>::find(key); }
+
+		pair<iterator, bool> insert(const Key& key);
+		pair<iterator, bool> emplace(Key&& key);
+	};
+}
+#endif
+
+namespace mud
+{
+	using stl::flat_set;
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#ifdef USE_STL
+#include <unordered_set>
+#else
+#include <stl/flat_set.h>
+#include <stl/flat_hash.hpp>
+
+namespace stl {
+
+	template <class Key, class Alloc>
+	inline pair<typename flat_set<Key, Alloc>::iterator, bool> flat_set<Key, Alloc>::insert(const Key& key) {
+		const pair<size_t, bool> slot = this->prepare(key);
+		if(slot.second)
+			new(placeholder(), &this->m_slots[slot.first]) Key(key);
+		return pair<iterator, bool>(iterator(this->m_ctrl + slot.first, this->m_slots + slot.first), slot.second);
+	}
+
+	template <class Key, class Alloc>
+	inline pair<typename flat_set<Key, Alloc>::iterator, bool> flat_set<Key, Alloc>::emplace(Key&& key) {
+		const pair<size_t, bool> slot = this->prepare(key);
+		if(slot.second)
+			new(placeholder(), &this->m_slots[slot.first]) Key(static_cast<Key&&>(key));
+		return pair<iterator, bool>(iterator(this->m_ctrl + slot.first, this->m_slots + slot.first), slot.second);
+	}
+}
+#endif
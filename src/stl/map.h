@@ -3,20 +3,36 @@
 
 #ifdef USE_STL
 #include <map>
+#include <unordered_map>
 namespace stl
 {
 	using std::map;
+
+	template <class K, class T>
+	using hash_map = std::unordered_map<K, T>;
 }
 #else
 #include <stl/unordered_map.h>
+#include <stl/flat_map.h>
 namespace stl
 {
 	template <class K, class T>
 	using map = stl::unordered_map<K, T>;
+
+	// maps looked up on hot paths : open addressing, so their values move when they grow
+	// defining MUD_CHAINED_MAPS switches them back to the chained table
+#ifdef MUD_CHAINED_MAPS
+	template <class K, class T>
+	using hash_map = stl::unordered_map<K, T>;
+#else
+	template <class K, class T>
+	using hash_map = stl::flat_map<K, T>;
+#endif
 }
 #endif
 
 namespace mud
 {
 	export_ using stl::map;
+	export_ using stl::hash_map;
 }
@@ -0,0 +1,114 @@
+#pragma once
+#include <infra/Config.h>
+
+#ifdef USE_STL
+#include <vector>
+namespace stl
+{
+	template <class T, size_t N>
+	using small_vector = std::vector<T>;
+}
+#else
+#include <stl/initializer_list.h>
+
+#include <stl/stddef.h>
+#include <stl/allocator.h>
+
+namespace stl {
+
+	// vector that keeps its first N elements inline, and only allocates once it holds more
+	// moving a small_vector moves its elements unless they are on the heap, so pointers to them don't survive a move
+	template <class T, size_t N, class Alloc = TINYSTL_ALLOCATOR>
+	class small_vector {
+	public:
+		static_assert(N > 0, "small_vector needs room for at least one element");
+
+		small_vector();
+		small_vector(const small_vector& other);
+		small_vector(small_vector&& other);
+		explicit small_vector(size_t size);
+		small_vector(size_t size, const T& value);
+		small_vector(const T* first, const T* last);
+		small_vector(std::initializer_list<T> list);
+		~small_vector();
+
+		small_vector& operator=(const small_vector& other);
+		small_vector& operator=(small_vector&& other);
+
+		const T* data() const { return m_first; }
+		T* data() { return m_first; }
+		size_t size() const { return size_t(m_last - m_first); }
+		size_t capacity() const { return size_t(m_capacity - m_first); }
+		bool empty() const { return m_last == m_first; }
+		bool small() const { return m_first == this->inline_first(); }
+
+		T& operator[](size_t idx) { return m_first[idx]; }
+		const T& operator[](size_t idx) const { return m_first[idx]; }
+
+		void reserve(size_t capacity);
+		void resize(size_t size);
+		void resize(size_t size, const T& value);
+		void clear();
+
+		using value_type = T;
+		using pointer = T*;
+
+		const T& front() const { return m_first[0]; }
+		T& front() { return m_first[0]; }
+		const T& back() const { return m_last[-1]; }
+		T& back() { return m_last[-1]; }
+
+		void push_back(const T& t);
+		void push_back(T&& t);
+		void emplace_back();
+		template <class... Params>
+		void emplace_back(Params&&... params);
+		void pop_back();
+
+		void append(const T* first, const T* last);
+
+		// moves the elements back inline when they fit
+		void shrink_to_fit();
+
+		using iterator = T*;
+		using const_iterator = const T*;
+
+		iterator begin() { return m_first; }
+		iterator end() { return m_last; }
+
+		const_iterator begin() const { return m_first; }
+		const_iterator end() const { return m_last; }
+
+		void assign(const T* first, const T* last);
+
+		iterator insert(iterator where, const T& value);
+		iterator insert(iterator where, T&& value);
+		iterator insert(iterator where, const T* first, const T* last);
+
+		template <class... Params>
+		void emplace(iterator where, Params&&... params);
+
+		iterator erase(iterator where);
+		iterator erase(iterator first, iterator last);
+
+	private:
+		T* inline_first() const { return reinterpret_cast<T*>(const_cast<unsigned char*>(m_inline)); }
+
+		void grow(size_t size);
+		void realloc(size_t capacity);
+		void release();
+		void take(small_vector& other);
+		T* spread(T* where, size_t count);
+
+		T* m_first;
+		T* m_last;
+		T* m_capacity;
+		alignas(T) unsigned char m_inline[N * sizeof(T)];
+	};
+}
+#endif
+
+namespace mud
+{
+	using stl::small_vector;
+}
@@ -0,0 +1,268 @@
+#pragma once
+
+#ifdef USE_STL
+#include <vector>
+#else
+#include <stl/small_vector.h>
+#include <stl/new.h>
+#include <stl/move_tiny.h>
+#include <stl/traits.h>
+#include <stl/buffer.hpp>
+
+namespace stl {
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>::small_vector()
+		: m_first(inline_first())
+		, m_last(m_first)
+		, m_capacity(m_first + N)
+	{}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>::small_vector(const small_vector& other)
+		: small_vector(other.m_first, other.m_last)
+	{}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>::small_vector(small_vector&& other)
+		: small_vector()
+	{
+		this->take(other);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>::small_vector(size_t size)
+		: small_vector()
+	{
+		this->resize(size);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>::small_vector(size_t size, const T& value)
+		: small_vector()
+	{
+		this->resize(size, value);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>::small_vector(const T* first, const T* last)
+		: small_vector()
+	{
+		this->append(first, last);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>::small_vector(std::initializer_list<T> list)
+		: small_vector()
+	{
+		this->append(list.begin(), list.end());
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>::~small_vector() {
+		destroy_urange(m_first, m_last);
+		this->release();
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>& small_vector<T, N, Alloc>::operator=(const small_vector& other) {
+		if(this != &other)
+			this->assign(other.m_first, other.m_last);
+		return *this;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline small_vector<T, N, Alloc>& small_vector<T, N, Alloc>::operator=(small_vector&& other) {
+		if(this != &other) {
+			this->clear();
+			this->release();
+			this->take(other);
+		}
+		return *this;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::release() {
+		if(m_first != this->inline_first())
+			Alloc::static_deallocate(m_first, sizeof(T) * this->capacity());
+		m_first = m_last = this->inline_first();
+		m_capacity = m_first + N;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::take(small_vector& other) {
+		// heap elements change hands, inline elements are moved one by one
+		if(!other.small()) {
+			m_first = other.m_first, m_last = other.m_last, m_capacity = other.m_capacity;
+			other.m_first = other.m_last = other.inline_first();
+			other.m_capacity = other.m_first + N;
+		} else {
+			move_urange(m_first, other.m_first, other.m_last);
+			m_last = m_first + other.size();
+			other.m_last = other.m_first;
+		}
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::realloc(size_t capacity) {
+		const size_t size = this->size();
+		T* first = capacity > N ? (T*)Alloc::static_allocate(sizeof(T) * capacity) : this->inline_first();
+		if(first == m_first)
+			return;
+		move_urange(first, m_first, m_last);
+		if(m_first != this->inline_first())
+			Alloc::static_deallocate(m_first, sizeof(T) * this->capacity());
+		m_first = first;
+		m_last = first + size;
+		m_capacity = first + (capacity > N ? capacity : N);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::reserve(size_t capacity) {
+		if(this->capacity() >= capacity)
+			return;
+		this->realloc(capacity);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::grow(size_t size) {
+		if(size > this->capacity())
+			this->realloc((size * 3) / 2);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::resize(size_t size) {
+		this->reserve(size);
+		fill_urange(m_last, m_first + size);
+		destroy_urange(m_first + size, m_last);
+		m_last = m_first + size;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::resize(size_t size, const T& value) {
+		this->reserve(size);
+		fill_urange(m_last, m_first + size, value);
+		destroy_urange(m_first + size, m_last);
+		m_last = m_first + size;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::clear() {
+		destroy_urange(m_first, m_last);
+		m_last = m_first;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::push_back(const T& t) {
+		this->grow(this->size() + 1);
+		copy_construct(m_last, t);
+		m_last++;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::push_back(T&& t) {
+		this->grow(this->size() + 1);
+		new(placeholder(), m_last) T(static_cast<T&&>(t));
+		m_last++;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::emplace_back() {
+		this->grow(this->size() + 1);
+		new(placeholder(), m_last) T();
+		m_last++;
+	}
+
+	template <class T, size_t N, class Alloc>
+	template <class... Params>
+	inline void small_vector<T, N, Alloc>::emplace_back(Params&&... params) {
+		this->grow(this->size() + 1);
+		new(placeholder(), m_last) T(static_cast<Params&&>(params)...);
+		m_last++;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::pop_back() {
+		destroy_urange(m_last - 1, m_last);
+		m_last--;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::append(const T* first, const T* last) {
+		const size_t count = size_t(last - first);
+		this->reserve(this->size() + count);
+		copy_urange(m_last, first, last);
+		m_last += count;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::shrink_to_fit() {
+		if(m_capacity != m_last && !this->small())
+			this->realloc(this->size());
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline void small_vector<T, N, Alloc>::assign(const T* first, const T* last) {
+		this->clear();
+		this->append(first, last);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline T* small_vector<T, N, Alloc>::spread(T* where, size_t count) {
+		const size_t offset = size_t(where - m_first);
+		const size_t newsize = this->size() + count;
+		this->grow(newsize);
+		where = m_first + offset;
+
+		if(where != m_last)
+			bmove_urange(where + count, where, m_last);
+		m_last = m_first + newsize;
+		return where;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::insert(iterator where, const T& value) {
+		where = this->spread(where, 1);
+		copy_construct(where, value);
+		return where;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::insert(iterator where, T&& value) {
+		where = this->spread(where, 1);
+		new(placeholder(), where) T(static_cast<T&&>(value));
+		return where;
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::insert(iterator where, const T* first, const T* last) {
+		where = this->spread(where, size_t(last - first));
+		copy_urange(where, first, last);
+		return where;
+	}
+
+	template <class T, size_t N, class Alloc>
+	template <class... Params>
+	inline void small_vector<T, N, Alloc>::emplace(iterator where, Params&&... params) {
+		where = this->spread(where, 1);
+		new(placeholder(), where) T(static_cast<Params&&>(params)...);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::erase(iterator where) {
+		return this->erase(where, where + 1);
+	}
+
+	template <class T, size_t N, class Alloc>
+	inline typename small_vector<T, N, Alloc>::iterator small_vector<T, N, Alloc>::erase(iterator first, iterator last) {
+		const size_t count = size_t(last - first);
+		for(pointer it = last, end = m_last, dest = first; it != end; ++it, ++dest)
+			move(*dest, *it);
+
+		destroy_urange(m_last - count, m_last);
+
+		m_last -= count;
+		return first;
+	}
+}
+#endif
@@ -33,6 +33,7 @@ namespace stl {
 
 		basic_string& operator=(const basic_string& other);
 		basic_string& operator=(basic_string&& other);
+		basic_string& operator=(const char* s);
 
 		const char* c_str() const;
 
@@ -55,6 +56,7 @@ namespace stl {
 		typedef const char* const_iterator;
 
 		void append(const char* first, const char* last);
+		void append(const char* s);
 		void append(const basic_string& other);
 		void assign(const char* first, const char* last);
 		void assign(const char* s, size_t n);
@@ -66,6 +68,7 @@ namespace stl {
 		void insert(iterator where, const basic_string& other);
 
 		basic_string& operator+=(const basic_string& other);
+		basic_string& operator+=(const char* s);
 
 		void erase(size_t pos = 0, size_t len = npos);
 		iterator erase(iterator where);
@@ -88,23 +91,32 @@ namespace stl {
 
 	private:
 		void reset(size_t size);
+		bool owns(const char* s) const;
 
 	protected:
-		static const size_t c_nbuffer = 12;
-		char m_small[12];
+		// strings shorter than this are stored inline : 16 fills the padding after the three pointers on 64-bit
+		static const size_t c_nbuffer = 16;
+		char m_small[c_nbuffer];
 	};
 
+	// compared in place, without building a string from the literal
 	template <class Alloc>
-	inline bool operator==(const basic_string<Alloc>& lhs, const char* rhs) { return lhs == basic_string<Alloc>(rhs); }
+	inline bool operator==(const basic_string<Alloc>& lhs, const char* rhs) {
+		const char* it = lhs.c_str(); const char* end = it + lhs.size();
+		for(; it != end; ++it, ++rhs)
+			if(*rhs == 0 || *it != *rhs)
+				return false;
+		return *rhs == 0;
+	}
 
 	template <class Alloc>
-	inline bool operator==(const char* lhs, const basic_string<Alloc>& rhs) { return basic_string<Alloc>(lhs) == rhs; }
+	inline bool operator==(const char* lhs, const basic_string<Alloc>& rhs) { return rhs == lhs; }
 
 	template <class Alloc>
-	inline bool operator!=(const basic_string<Alloc>& lhs, const char* rhs) { return lhs != basic_string<Alloc>(rhs); }
+	inline bool operator!=(const basic_string<Alloc>& lhs, const char* rhs) { return !(lhs == rhs); }
 
 	template <class Alloc>
-	inline bool operator!=(const char* lhs, const basic_string<Alloc>& rhs) { return basic_string<Alloc>(lhs) != rhs; }
+	inline bool operator!=(const char* lhs, const basic_string<Alloc>& rhs) { return !(rhs == lhs); }
 
 	template <class Alloc>
 	basic_string<Alloc> operator+(const basic_string<Alloc>& lhs, const basic_string<Alloc>& rhs);
@@ -14,8 +14,9 @@ namespace stl {
 	template <class Alloc>
 	inline basic_string<Alloc>::basic_string()
 	{
+		// the last byte of the small buffer is kept for the terminating zero
 		this->m_first = this->m_last = m_small;
-		this->m_capacity = m_small + c_nbuffer;
+		this->m_capacity = m_small + c_nbuffer - 1;
 	}
 
 	template <class Alloc>
@@ -94,13 +95,15 @@ namespace stl {
 	inline void basic_string<Alloc>::reset(size_t size) {
 		this->m_first = m_small;
 		this->m_last = m_small + size;
-		this->m_capacity = m_small + c_nbuffer;
+		this->m_capacity = m_small + c_nbuffer - 1;
 		m_small[size] = 0;
 	}
 
 	template <class Alloc>
 	basic_string<Alloc>& basic_string<Alloc>::operator=(const basic_string& other) {
-		basic_string(other).swap(*this);
+		// reuses the current capacity when it's large enough
+		if(this != &other)
+			this->assign(other.m_first, other.m_last);
 		return *this;
 	}
 
@@ -110,6 +113,13 @@ namespace stl {
 		return *this;
 	}
 
+	template <class Alloc>
+	basic_string<Alloc>& basic_string<Alloc>::operator=(const char* s) {
+		// a null string, like the one of s = {}, is empty
+		this->assign(s, s ? length(s) : 0);
+		return *this;
+	}
+
 	template <class Alloc>
 	inline void basic_string<Alloc>::resize(size_t size) {
 		this->reserve(size);
@@ -142,6 +152,8 @@ namespace stl {
 
 	template <class Alloc>
 	inline void basic_string<Alloc>::reserve(size_t capacity) {
+		if(this->m_first == m_small && capacity + 1 <= c_nbuffer)
+			return;
 		buffer<char, Alloc, 1>::reserve(capacity, this->m_first != m_small);
 	}
 
@@ -191,13 +203,25 @@ namespace stl {
 
 	template <class Alloc>
 	inline void basic_string<Alloc>::append(const char* first, const char* last) {
-		const size_t newsize = size_t(this->size() + (last - first));
-		this->grow(newsize, this->m_first != m_small);
+		// the source can be a part of this string, as in s.append(s) : it's found again after growing, which might move it
+		const bool own = this->owns(first);
+		const size_t offset = size_t(first - this->m_first);
+		const size_t count = size_t(last - first);
+		this->grow(this->size() + count, this->m_first != m_small);
+		if(own) {
+			first = this->m_first + offset;
+			last = first + count;
+		}
 		copy_urange(this->m_last, first, last);
 		this->m_last += last - first;
 		*this->m_last = 0;
 	}
 
+	template <class Alloc>
+	inline void basic_string<Alloc>::append(const char* s) {
+		this->append(s, s + length(s));
+	}
+
 	template <class Alloc>
 	inline void basic_string<Alloc>::append(const basic_string& other) {
 		this->append(other.begin(), other.end());
@@ -205,14 +229,25 @@ namespace stl {
 
 	template <class Alloc>
 	inline void basic_string<Alloc>::assign(const char* first, const char* last) {
+		// the source can be a part of this string, as in s = s.c_str() + n : it's copied forward to the front, before anything is cleared
+		if(this->owns(first)) {
+			copy_urange(this->m_first, first, last);
+			this->m_last = this->m_first + (last - first);
+			*this->m_last = 0;
+			return;
+		}
 		this->clear();
 		this->append(first, last);
 	}
 
 	template <class Alloc>
 	inline void basic_string<Alloc>::assign(const char* s, size_t n) {
-		this->clear();
-		this->append(s, s + n);
+		this->assign(s, s + n);
+	}
+
+	template <class Alloc>
+	inline bool basic_string<Alloc>::owns(const char* s) const {
+		return s >= this->m_first && s <= this->m_last;
 	}
 
 	template <class Alloc>
@@ -254,6 +289,12 @@ namespace stl {
 		return *this;
 	}
 
+	template <class Alloc>
+	inline basic_string<Alloc>& basic_string<Alloc>::operator+=(const char* s) {
+		this->append(s);
+		return *this;
+	}
+
 	template <class Alloc>
 	inline void basic_string<Alloc>::erase(size_t pos, size_t len) {
 		this->erase(this->m_first + pos, len == npos ? this->m_last : this->m_first + pos + len);
@@ -433,13 +474,23 @@ namespace stl {
 	template <class Alloc>
 	inline basic_string<Alloc> operator+(const basic_string<Alloc>& lhs, const char* rhs)
 	{
-		return operator+(lhs, basic_string<Alloc>(rhs));
+		const size_t count = length(rhs);
+		basic_string<Alloc> result;
+		result.reserve(lhs.size() + count);
+		result.append(lhs);
+		result.append(rhs, rhs + count);
+		return result;
 	}
 
 	template <class Alloc>
 	inline basic_string<Alloc> operator+(const char* lhs, const basic_string<Alloc>& rhs)
 	{
-		return operator+(basic_string<Alloc>(lhs), rhs);
+		const size_t count = length(lhs);
+		basic_string<Alloc> result;
+		result.reserve(count + rhs.size());
+		result.append(lhs, lhs + count);
+		result.append(rhs);
+		return result;
 	}
 }
 #endif
@@ -169,6 +169,12 @@ namespace stl
 	constexpr bool is_invocable = is_invocable_base<T, Args...>::value;
 #endif
 
+	template<class T>
+	constexpr bool is_const = false;
+
+	template<class T>
+	constexpr bool is_const<const T> = true;
+
 	template<class T>
 	constexpr bool is_pointer = false;
 
@@ -228,5 +234,5 @@ namespace mud
 	using stl::is_invocable; using stl::is_invocable_r;
 	using stl::is_copy_assignable;
 	using stl::is_constructible; using stl::is_copy_constructible; using stl::is_default_constructible;
-	using stl::is_pointer; using stl::is_integral; using stl::is_signed; using stl::is_unsigned;
+	using stl::is_const; using stl::is_pointer; using stl::is_integral; using stl::is_signed; using stl::is_unsigned;
 }
\ No newline at end of file
@@ -6,6 +6,9 @@ namespace stl
 {
 	template<class T>
 	constexpr bool is_trivially_destructible = __is_trivially_destructible(T);
+
+	template<class T>
+	constexpr bool is_trivially_copyable = __is_trivially_copyable(T);
 }
 #else
 #include <type_traits>
@@ -13,6 +16,9 @@ namespace stl
 {
 	template <class T>
 	constexpr bool is_trivially_destructible = std::is_trivially_destructible_v<T>;
+
+	template <class T>
+	constexpr bool is_trivially_copyable = std::is_trivially_copyable_v<T>;
 }
 #endif
 
@@ -20,4 +26,5 @@ namespace mud
 {
 	//using stl::is_function;
 	using stl::is_trivially_destructible;
+	using stl::is_trivially_copyable;
 }
@@ -6,6 +6,7 @@
 
 #include <stdint.h>
 #include <stl/vector.h>
+#include <stl/small_vector.h>
 #include <stl/memory.h>
 #include <infra/Config.h>
 
@@ -37,7 +38,8 @@ namespace mud
 		T* m_parent = nullptr;
 		void* m_identity = nullptr;
 		size_t m_heartbeat = 0;
-		vector<unique<T>> m_nodes;
+		// most nodes have a handful of children, that don't need an allocation
+		small_vector<unique<T>, 4> m_nodes;
 		unique<NodeState> m_state;
 		uint16_t m_next = 0;
 		
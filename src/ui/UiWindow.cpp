@@ -165,6 +165,8 @@ namespace mud
 
 	bool UiWindow::input_frame()
 	{
+		alloc_scope tag(alloc_tag::ui);
+
 		bool pursue = !m_shutdown;
 		pursue &= m_context.next_frame();
 
@@ -180,6 +182,8 @@ namespace mud
 
 	void UiWindow::render_frame()
 	{
+		alloc_scope tag(alloc_tag::ui);
+
 		//m_root_sheet->render_frame();
 
 		if(m_context.m_render_system.m_manual_render)
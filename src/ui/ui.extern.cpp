@@ -3,6 +3,7 @@
 module mud.math;
 #else
 #include <stl/vector.hpp>
+#include <stl/small_vector.hpp>
 #include <stl/unordered_set.hpp>
 #include <stl/unordered_map.hpp>
 #include <ui/Api.h>
@@ -31,7 +32,7 @@ namespace stl
 	template class MUD_UI_EXPORT vector<InkStyle>;
 	template class MUD_UI_EXPORT vector<FrameSolver>;
 	template class MUD_UI_EXPORT vector<RowSolver>;
-	template class MUD_UI_EXPORT vector<unique<Widget>>;
+	template class MUD_UI_EXPORT small_vector<unique<Widget>, 4>;
 	template class MUD_UI_EXPORT vector<unique<FrameSolver>>;
 	template class MUD_UI_EXPORT vector<unique<Image>>;
 	template class MUD_UI_EXPORT unordered_map<int, InputEvent*>;
@@ -219,13 +219,13 @@ namespace mud
 		Table& self = ui::table(parent, { columns, 2 }, { spans, 2 });
 
 		EntityStream& stream = s_ecs[entity.m_ecs]->stream(entity);
-		uint32_t index = stream.m_handles[entity];
-		for(auto& buffer : stream.m_buffers)
+		uint32_t index = stream.index(entity);
+		for(uint32_t c = 0; c < uint32_t(stream.m_columns.size()); ++c)
 		{
 			Widget& row = ui::table_separator(self);
-			Widget* body = ui::tree_node(row, buffer->m_type->m_name, false, true).m_body;
+			Widget* body = ui::tree_node(row, stream.m_columns[c].m_type->m_name, false, true).m_body;
 			if(body)
-				changed |= object_edit_columns(*body, buffer->get(index));
+				changed |= object_edit_columns(*body, stream.get(c, index));
 		}
 
 		return changed;
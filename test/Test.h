@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdio>
+
+namespace mud
+{
+namespace test
+{
+	inline int& failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline void check(bool condition, const char* expression, const char* file, int line)
+	{
+		if(condition)
+			return;
+		fprintf(stderr, "ERROR: %s:%i check failed : %s\n", file, line, expression);
+		failures()++;
+	}
+
+	// the exit code of a test binary
+	inline int result(const char* name)
+	{
+		if(failures())
+			fprintf(stderr, "ERROR: %s - %i checks failed\n", name, failures());
+		else
+			fprintf(stderr, "INFO: %s - all checks passed\n", name);
+		return failures() ? 1 : 0;
+	}
+}
+}
+
+#define MUD_CHECK(condition) mud::test::check(bool(condition), #condition, __FILE__, __LINE__)
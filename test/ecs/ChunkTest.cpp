@@ -0,0 +1,55 @@
+#include <test/ecs/EcsTest.h>
+
+using namespace mud;
+using namespace mud::test;
+
+namespace
+{
+	// rows fill fixed size chunks in order, each component laid out as an array within the chunk
+	void chunk_layout()
+	{
+		ECS ecs;
+		const uint16_t index = ecs.stream_index<Position, Health>();
+		EntityStream& stream = ecs.m_streams[index];
+		const uint32_t capacity = stream.m_capacity;
+		MUD_CHECK(capacity > 1 && stream.m_chunk_size == EntityStream::CHUNK_SIZE);
+
+		vector<uint32_t> handles;
+		for(uint32_t i = 0; i < capacity * 2 + 1; ++i)
+		{
+			handles.push_back(ecs.create<Position, Health>());
+			ecs.get<Position>(handles.back()).x = float(i);
+			ecs.get<Health>(handles.back()).hp = int32_t(i);
+		}
+
+		MUD_CHECK(stream.chunk_count() == 3);
+		MUD_CHECK(stream.chunk_size(0) == capacity && stream.chunk_size(2) == 1);
+
+		for(uint32_t c = 0; c < stream.chunk_count(); ++c)
+		{
+			Position* positions = stream.array<Position>(c);
+			Health* healths = stream.array<Health>(c);
+			for(uint32_t i = 0; i < stream.chunk_size(c); ++i)
+			{
+				const uint32_t row = c * capacity + i;
+				MUD_CHECK(stream.handles(c)[i] == handles[row]);
+				MUD_CHECK(positions[i].x == float(row) && healths[i].hp == int32_t(row));
+				MUD_CHECK(static_cast<void*>(&positions[i]) >= static_cast<void*>(stream.m_chunks[c])
+						  && static_cast<char*>(static_cast<void*>(&healths[i])) < stream.m_chunks[c] + stream.m_chunk_size);
+			}
+		}
+
+		// the last row is swapped into the hole, and the emptied chunk is released
+		ecs.destroy(handles[0]);
+		MUD_CHECK(stream.chunk_count() == 2);
+		MUD_CHECK(stream.handles(0)[0] == handles.back());
+		MUD_CHECK(ecs.get<Position>(handles.back()).x == float(capacity * 2));
+		for(uint32_t i = 1; i < uint32_t(handles.size()); ++i)
+			MUD_CHECK(ecs.get<Health>(handles[i]).hp == int32_t(i));
+	}
+}
+
+void mud::test::chunk_tests()
+{
+	chunk_layout();
+}
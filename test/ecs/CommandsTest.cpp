@@ -0,0 +1,133 @@
+#include <test/ecs/EcsTest.h>
+#include <ecs/Commands.h>
+#include <ecs/Commands.hpp>
+
+using namespace mud;
+using namespace mud::test;
+
+namespace
+{
+	// commands are applied by key, then by buffer, then in recording order : the last one applied wins
+	void apply_order()
+	{
+		ECS ecs;
+		ecs.add_stream<Position, Health>("units");
+		const uint32_t a = ecs.create<Position, Health>();
+		const uint32_t b = ecs.create<Position, Health>();
+		const uint32_t c = ecs.create<Position, Health>();
+
+		CommandBuffers buffers(ecs, 2);
+		CommandBuffer& first = buffers.buffer(0);
+		CommandBuffer& second = buffers.buffer(1);
+
+		// same key : the second buffer is applied after the first, whichever recorded first
+		second.key(0);
+		second.set<Health>(a, Health{ 1 });
+		first.key(0);
+		first.set<Health>(a, Health{ 2 });
+
+		// a lower key is applied first, whichever buffer it's in
+		first.key(5);
+		first.set<Health>(b, Health{ 3 });
+		second.key(2);
+		second.set<Health>(b, Health{ 4 });
+
+		// same key and buffer : recording order
+		first.key(7);
+		first.set<Health>(c, Health{ 5 });
+		first.set<Health>(c, Health{ 6 });
+
+		buffers.apply();
+
+		MUD_CHECK(ecs.get<Health>(a).hp == 1);
+		MUD_CHECK(ecs.get<Health>(b).hp == 3);
+		MUD_CHECK(ecs.get<Health>(c).hp == 6);
+		MUD_CHECK(first.m_commands.empty() && second.m_commands.empty());
+	}
+
+	// commands on an entity destroyed earlier in the batch are dropped, and their values destroyed
+	void dead_entities()
+	{
+		{
+			ECS ecs;
+			ecs.add_stream<Position>("points");
+			// a stream keeps a default constructed row : the one with a Tracked column is created upfront
+			ecs.add_stream<Position, Tracked>("tracked");
+			const int32_t baseline = Tracked::live();
+			const uint32_t dead = ecs.create<Position>();
+			const uint32_t alive = ecs.create<Position>();
+
+			CommandBuffers buffers(ecs, 1);
+			CommandBuffer& buffer = buffers.buffer(0);
+			buffer.key(0);
+			buffer.destroy(dead);
+			buffer.key(1);
+			buffer.add<Tracked>(dead, Tracked(1));
+			buffer.add<Tracked>(alive, Tracked(2));
+			buffer.set<Position>(dead, Position{ 3.f });
+			buffer.remove<Position>(dead);
+
+			// created and written in the same batch
+			const uint32_t created = buffer.create<Position>();
+			buffer.set<Position>(created, Position{ 4.f });
+
+			buffers.apply();
+
+			MUD_CHECK(!ecs.alive(dead));
+			MUD_CHECK(ecs.alive(alive) && ecs.has<Tracked>(alive) && ecs.get<Tracked>(alive).m_value == 2);
+			MUD_CHECK(ecs.alive(created) && ecs.get<Position>(created).x == 4.f);
+			MUD_CHECK(Tracked::live() == baseline + 1);
+		}
+		MUD_CHECK(Tracked::live() == 0);
+	}
+
+	// runs of adds and removes of one component are migrated as a batch : rows span several chunks, and every
+	// erase swaps the last row of the source stream in, so all values are checked after the batch
+	void batched_runs()
+	{
+		ECS ecs;
+		const uint16_t points = ecs.stream_index<Position>();
+		const uint32_t count = ecs.m_streams[points].m_capacity * 3 + 7;
+
+		vector<uint32_t> handles;
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			handles.push_back(ecs.create<Position>());
+			ecs.get<Position>(handles.back()).x = float(i);
+		}
+
+		CommandBuffers buffers(ecs, 2);
+		for(uint32_t i = 0; i < count; ++i)
+			if(i % 3 != 1)
+			{
+				CommandBuffer& buffer = buffers.buffer(i % 2);
+				buffer.key(0);
+				buffer.add<Velocity>(handles[i], Velocity{ float(i) * 2.f });
+			}
+		buffers.buffer(0).key(1);
+		for(uint32_t i = 0; i < count; i += 4)
+			buffers.buffer(0).remove<Position>(handles[i]);
+
+		buffers.apply();
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t handle = handles[i];
+			const bool velocity = i % 3 != 1;
+			const bool position = i % 4 != 0;
+			MUD_CHECK(ecs.has<Velocity>(handle) == velocity);
+			MUD_CHECK(ecs.has<Position>(handle) == position);
+			if(velocity)
+				MUD_CHECK(ecs.get<Velocity>(handle).v == float(i) * 2.f);
+			if(position)
+				MUD_CHECK(ecs.get<Position>(handle).x == float(i));
+		}
+	}
+}
+
+void mud::test::command_tests()
+{
+	apply_order();
+	dead_entities();
+	batched_runs();
+}
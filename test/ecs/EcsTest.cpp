@@ -0,0 +1,14 @@
+#include <test/ecs/EcsTest.h>
+
+// usage : mud_ecs_test
+
+int main()
+{
+	mud::test::snapshot_tests();
+	mud::test::command_tests();
+	mud::test::migrate_tests();
+	mud::test::chunk_tests();
+	mud::test::query_tests();
+	mud::test::system_tests();
+	return mud::test::result("ecs");
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stl/vector.hpp>
+#include <ecs/ECS.h>
+#include <ecs/ECS.hpp>
+#include <test/Test.h>
+
+// components shared by the ecs tests
+namespace mud
+{
+namespace test
+{
+	struct Position { float x = 0.f; };
+	struct Velocity { float v = 0.f; };
+	struct Health { int32_t hp = 100; };
+
+	// not trivially copyable, and counts its live instances to catch leaked or doubly destroyed values
+	struct Tracked
+	{
+		Tracked(int32_t value = 0) : m_value(value) { live()++; }
+		Tracked(const Tracked& other) : m_value(other.m_value) { live()++; }
+		Tracked(Tracked&& other) : m_value(other.m_value) { live()++; }
+		Tracked& operator=(const Tracked& other) { m_value = other.m_value; return *this; }
+		Tracked& operator=(Tracked&& other) { m_value = other.m_value; return *this; }
+		~Tracked() { live()--; }
+
+		static int32_t& live() { static int32_t count = 0; return count; }
+
+		int32_t m_value;
+	};
+
+	void snapshot_tests();
+	void command_tests();
+	void migrate_tests();
+	void chunk_tests();
+	void query_tests();
+	void system_tests();
+}
+
+	template <> struct TypedBuffer<test::Position> { static uint32_t index() { return 0; } };
+	template <> struct TypedBuffer<test::Velocity> { static uint32_t index() { return 1; } };
+	template <> struct TypedBuffer<test::Health> { static uint32_t index() { return 2; } };
+	template <> struct TypedBuffer<test::Tracked> { static uint32_t index() { return 3; } };
+
+	template <> inline Type& type<test::Position>() { static Type ty("Position"); return ty; }
+	template <> inline Type& type<test::Velocity>() { static Type ty("Velocity"); return ty; }
+	template <> inline Type& type<test::Health>() { static Type ty("Health"); return ty; }
+	template <> inline Type& type<test::Tracked>() { static Type ty("Tracked"); return ty; }
+}
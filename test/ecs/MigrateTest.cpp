@@ -0,0 +1,67 @@
+#include <test/ecs/EcsTest.h>
+
+using namespace mud;
+using namespace mud::test;
+
+namespace
+{
+	// one batch over rows spread across chunks : the removed rows are swap erased from the source, which moves rows still to migrate
+	void batch_migrate()
+	{
+		ECS ecs;
+		const uint16_t units = ecs.stream_index<Position, Health>();
+		const uint32_t count = ecs.m_streams[units].m_capacity * 2 + 5;
+
+		vector<uint32_t> handles;
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			handles.push_back(ecs.create<Position, Health>());
+			ecs.get<Position>(handles.back()).x = float(i);
+			ecs.get<Health>(handles.back()).hp = int32_t(i);
+		}
+
+		vector<uint32_t> batch;
+		for(uint32_t i = 0; i < count; ++i)
+			if(i % 3 == 0 || i > count - 4)
+				batch.push_back(handles[i]);
+
+		const ComponentColumn& velocity = component_desc<Velocity>();
+		ecs.migrate(batch, component_flag(velocity.m_index), component_mask<Health>(), &velocity);
+
+		for(uint32_t i = 0; i < count; ++i)
+		{
+			const uint32_t handle = handles[i];
+			const bool moved = i % 3 == 0 || i > count - 4;
+			MUD_CHECK(ecs.get<Position>(handle).x == float(i));
+			MUD_CHECK(ecs.has<Velocity>(handle) == moved);
+			MUD_CHECK(ecs.has<Health>(handle) == !moved);
+			if(moved)
+				MUD_CHECK(ecs.get<Velocity>(handle).v == 0.f);
+			else
+				MUD_CHECK(ecs.get<Health>(handle).hp == int32_t(i));
+		}
+	}
+
+	// several components added at once get a column each, the ones known to the ecs without being passed
+	void multiple_adds()
+	{
+		ECS ecs;
+		ecs.add_stream<Velocity, Health>("moving");
+		uint32_t handle = ecs.create<Position>();
+		ecs.get<Position>(handle).x = 3.f;
+
+		ecs.migrate({ &handle, 1 }, component_mask<Velocity, Health>(), {});
+
+		MUD_CHECK(ecs.has<Velocity>(handle) && ecs.has<Health>(handle));
+		MUD_CHECK(ecs.get<Position>(handle).x == 3.f);
+		MUD_CHECK(ecs.get<Health>(handle).hp == 100);
+		ecs.get<Velocity>(handle).v = 2.f;
+		MUD_CHECK(ecs.get<Velocity>(handle).v == 2.f);
+	}
+}
+
+void mud::test::migrate_tests()
+{
+	batch_migrate();
+	multiple_adds();
+}
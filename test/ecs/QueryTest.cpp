@@ -0,0 +1,71 @@
+#include <test/ecs/EcsTest.h>
+
+using namespace mud;
+using namespace mud::test;
+
+namespace
+{
+	// a registered query matches the streams added after it, whether declared, created with an entity or by a migration
+	void later_streams()
+	{
+		ECS ecs;
+		Query& query = ecs.query(with<Position>().without<Health>());
+		MUD_CHECK(query.m_streams.empty());
+		MUD_CHECK(&ecs.query(with<Position>().without<Health>()) == &query);
+
+		ecs.add_stream<Position>("points");
+		const uint32_t a = ecs.create<Position>();
+		const uint32_t b = ecs.create<Position, Velocity>();
+		ecs.create<Position, Health>();
+		ecs.create<Velocity>();
+		ecs.add<Tracked>(a, Tracked(1));
+
+		MUD_CHECK(query.m_streams.size() == 3);
+
+		uint32_t count = 0;
+		ecs.loop_ent<Position>(query, [&](uint32_t handle, Position&)
+		{
+			MUD_CHECK(handle == a || handle == b);
+			count++;
+		});
+		MUD_CHECK(count == 2);
+	}
+
+	// iterated since a version, a changed<> query only visits the chunks where one of its changed components was written
+	void changed_chunks()
+	{
+		ECS ecs;
+		const uint16_t index = ecs.stream_index<Position, Velocity>();
+		EntityStream& stream = ecs.m_streams[index];
+
+		vector<uint32_t> handles;
+		for(uint32_t i = 0; i < stream.m_capacity * 3; ++i)
+			handles.push_back(ecs.create<Position, Velocity>());
+
+		Query& query = ecs.query(with<Velocity>().changed<Position>());
+		auto visited = [&](uint32_t since)
+		{
+			uint32_t count = 0;
+			ecs.loop_ent<Velocity>(query, [&](uint32_t handle, Velocity&) { MUD_CHECK(stream.chunk(handle) == 1); count++; }, since);
+			return count;
+		};
+
+		// the version is advanced before writing, so that the writes are seen since the previous one
+		uint32_t since = ecs.m_version;
+		ecs.advance();
+		ecs.get<Position>(handles[stream.m_capacity + 2]).x = 1.f;
+		MUD_CHECK(visited(since) == stream.m_capacity);
+
+		// writing the other components doesn't make a chunk visited
+		since = ecs.m_version;
+		ecs.advance();
+		ecs.get<Velocity>(handles[0]).v = 1.f;
+		MUD_CHECK(visited(since) == 0);
+	}
+}
+
+void mud::test::query_tests()
+{
+	later_streams();
+	changed_chunks();
+}
@@ -0,0 +1,48 @@
+#include <test/ecs/EcsTest.h>
+#include <ecs/Snapshot.h>
+
+using namespace mud;
+using namespace mud::test;
+
+namespace
+{
+	// a system that ran at the version of the world before the load must still see the writes made after it
+	void load_behind_version()
+	{
+		ECS saved;
+		saved.add_stream<Position>("positions");
+		saved.create<Position>();
+		vector<uint8_t> data;
+		const uint32_t snapshot = save_snapshot(saved, data);
+
+		ECS ecs;
+		ecs.add_stream<Position>("positions");
+		for(uint32_t i = 0; i < 100; ++i)
+			ecs.advance();
+		MUD_CHECK(ecs.m_version > snapshot);
+
+		Query& query = ecs.query(with<Position>().changed<Position>());
+		const uint32_t since = ecs.m_version;
+		ecs.advance();
+
+		MUD_CHECK(load_snapshot(ecs, data));
+		MUD_CHECK(ecs.m_version > since);
+
+		uint32_t visited = 0;
+		ecs.loop<Position>(query, [&](Position&) { visited++; }, since);
+		MUD_CHECK(visited == 1);
+
+		const uint32_t after = ecs.m_version;
+		ecs.advance();
+		ecs.get<Position>(0).x = 1.f;
+
+		visited = 0;
+		ecs.loop<Position>(query, [&](Position& position) { visited++; MUD_CHECK(position.x == 1.f); }, after);
+		MUD_CHECK(visited == 1);
+	}
+}
+
+void mud::test::snapshot_tests()
+{
+	load_behind_version();
+}
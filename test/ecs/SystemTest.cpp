@@ -0,0 +1,75 @@
+#include <test/ecs/EcsTest.h>
+#include <jobs/JobSystem.h>
+#include <jobs/Job.h>
+#include <ecs/System.h>
+#include <ecs/System.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace mud;
+using namespace mud::test;
+
+namespace
+{
+	// systems writing what another accesses are ordered as they were added, the others may overlap
+	void conflicting_systems()
+	{
+		JobSystem js(4, 1);
+		js.adopt();
+
+		ECS ecs;
+		SystemScheduler scheduler(ecs);
+
+		const SystemAccess accesses[] = {
+			system_access<Position>(),
+			system_access<const Position>(),
+			system_access<Velocity>(),
+			system_access<const Position, const Velocity>(),
+			system_access<Position, Velocity>(),
+			system_access<const Health>(),
+			system_access<const Position>(),
+		};
+		const uint32_t count = uint32_t(sizeof(accesses) / sizeof(accesses[0]));
+
+		// begin and end of each system on a shared clock, and the systems running at any time
+		std::atomic<uint32_t> clock = { 0 };
+		std::atomic<uint32_t> running = { 0 };
+		uint32_t begins[count] = {};
+		uint32_t ends[count] = {};
+
+		for(uint32_t i = 0; i < count; ++i)
+			scheduler.add("system", accesses[i], [&, i](JobSystem&, Job*)
+			{
+				const uint32_t mask = running.fetch_or(1 << i);
+				for(uint32_t j = 0; j < count; ++j)
+					if(mask & (1 << j))
+						MUD_CHECK(!accesses[i].conflicts(accesses[j]));
+
+				begins[i] = clock++;
+				std::this_thread::sleep_for(std::chrono::milliseconds(2));
+				ends[i] = clock++;
+				running.fetch_and(~(1 << i));
+			});
+
+		for(uint32_t run = 0; run < 10; ++run)
+		{
+			scheduler.run(js);
+			for(uint32_t i = 0; i < count; ++i)
+				for(uint32_t j = i + 1; j < count; ++j)
+					if(accesses[i].conflicts(accesses[j]))
+						MUD_CHECK(ends[i] < begins[j]);
+		}
+
+		for(const unique<System>& system : scheduler.m_systems)
+			MUD_CHECK(system->m_runs == 10);
+
+		js.emancipate();
+	}
+}
+
+void mud::test::system_tests()
+{
+	conflicting_systems();
+}
@@ -0,0 +1,61 @@
+#include <jobs/JobSystem.h>
+#include <jobs/Job.h>
+#include <test/Test.h>
+#include <test/jobs/JobsTest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+
+using namespace mud;
+
+namespace
+{
+	// a hang is reported as a failure instead of blocking the whole test run
+	void watchdog(std::atomic<bool>& done, const char* name)
+	{
+		std::thread([&done, name]()
+		{
+			for(uint32_t i = 0; i < 100 && !done.load(); ++i)
+				std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			if(!done.load())
+			{
+				fprintf(stderr, "ERROR: %s never completed\n", name);
+				exit(1);
+			}
+		}).detach();
+	}
+}
+
+// the waiting thread doesn't execute background jobs : a background child of the job it waits on must be run by a worker, even if they're all parked
+void mud::test::background_wait()
+{
+	JobSystemConfig config;
+	config.m_spin_count = 1;
+	JobSystem js(2, 1, config);
+	js.adopt();
+
+	static std::atomic<bool> done = { false };
+	watchdog(done, "background_wait");
+
+	for(uint32_t i = 0; i < 10; ++i)
+	{
+		// lets the workers run out of work and park
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+		// the root is run by this thread, and queues the child where nothing else is pending
+		std::atomic<uint32_t> ran = { 0 };
+		Job* root = js.job(nullptr, [&](JobSystem& js, Job* job)
+		{
+			Job* child = js.job(job, [&](JobSystem&, Job*) { ran++; });
+			js.set_priority(child, JobPriority::Background);
+			js.run(child);
+		});
+		js.complete(root);
+		MUD_CHECK(ran == 1);
+	}
+
+	done = true;
+	js.emancipate();
+}
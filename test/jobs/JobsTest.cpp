@@ -0,0 +1,12 @@
+#include <test/Test.h>
+#include <test/jobs/JobsTest.h>
+
+// usage : mud_jobs_test
+
+int main()
+{
+	mud::test::tasks();
+	mud::test::background_wait();
+	mud::test::trace_window();
+	return mud::test::result("jobs");
+}
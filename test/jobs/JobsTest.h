@@ -0,0 +1,11 @@
+#pragma once
+
+namespace mud
+{
+namespace test
+{
+	void tasks();
+	void background_wait();
+	void trace_window();
+}
+}
@@ -0,0 +1,52 @@
+#include <jobs/JobSystem.h>
+#include <jobs/Task.h>
+#include <test/Test.h>
+#include <test/jobs/JobsTest.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace mud;
+
+#ifdef MUD_JOBS_COROUTINES
+namespace
+{
+	constexpr uint32_t ROUNDS = 5;
+	constexpr uint32_t SPAWNS = 20000;
+
+	std::atomic<uint32_t> s_done = { 0 };
+
+	task<void> work()
+	{
+		s_done.fetch_add(1, std::memory_order_relaxed);
+		co_return;
+	}
+
+	// tasks are spawned on this thread, which doesn't execute jobs : the frames are all freed by the workers
+	// they must find their way back to this thread, or it allocates new ones for every round
+	// a round has at most two frames per spawn in flight, the spawn and the work, on top of what the threads cache
+	void spawn_here_complete_there(JobSystem& js)
+	{
+		for(uint32_t round = 0; round < ROUNDS; ++round)
+		{
+			s_done = 0;
+			for(uint32_t i = 0; i < SPAWNS; ++i)
+				spawn(js, work());
+			while(s_done.load(std::memory_order_relaxed) < SPAWNS)
+				std::this_thread::yield();
+
+			MUD_CHECK(TaskFramePool::allocated() <= 2 * SPAWNS + 4096);
+		}
+	}
+}
+#endif
+
+void mud::test::tasks()
+{
+#ifdef MUD_JOBS_COROUTINES
+	JobSystem js(4, 1);
+	js.adopt();
+	spawn_here_complete_there(js);
+	js.emancipate();
+#endif
+}
@@ -0,0 +1,59 @@
+#include <jobs/JobTrace.h>
+#include <test/Test.h>
+#include <test/jobs/JobsTest.h>
+
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <thread>
+
+using namespace mud;
+
+namespace
+{
+	// the events of one phase of the trace file, B or E
+	uint32_t count(const char* text, const char* phase)
+	{
+		uint32_t result = 0;
+		for(const char* at = strstr(text, phase); at; at = strstr(at + 1, phase))
+			result++;
+		return result;
+	}
+
+	void elapse() { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+}
+
+// a frame window starting inside a job and ending inside another one keeps only the spans it fully contains
+void mud::test::trace_window()
+{
+	JobTracer tracer(1);
+	tracer.enable(true);
+
+	tracer.record(0, JobEvent::JobBegin, 1);
+	elapse();
+	tracer.frame();
+	elapse();
+	tracer.record(0, JobEvent::JobEnd);
+	tracer.record(0, JobEvent::ParkBegin);
+	tracer.record(0, JobEvent::ParkEnd);
+	tracer.record(0, JobEvent::JobBegin, 2);
+	tracer.record(0, JobEvent::JobEnd);
+	tracer.record(0, JobEvent::JobBegin, 3);
+
+	const char* path = "job_trace_test.json";
+	MUD_CHECK(tracer.dump(path, 1));
+
+	char text[4096] = {};
+	FILE* file = fopen(path, "r");
+	MUD_CHECK(file != nullptr);
+	if(!file)
+		return;
+	fread(text, 1, sizeof(text) - 1, file);
+	fclose(file);
+	remove(path);
+
+	MUD_CHECK(count(text, "\"ph\":\"B\"") == 2);
+	MUD_CHECK(count(text, "\"ph\":\"E\"") == 2);
+	MUD_CHECK(strstr(text, "\"job\":1") == nullptr && strstr(text, "\"job\":3") == nullptr);
+	MUD_CHECK(strstr(text, "\"job\":2") != nullptr);
+}
@@ -0,0 +1,111 @@
+#include <stl/vector.hpp>
+#include <stl/small_vector.hpp>
+#include <stl/string.hpp>
+#include <test/Test.h>
+
+// usage : mud_stl_test
+
+using namespace mud;
+
+namespace
+{
+	// allocator that counts the allocations of the containers it's given to
+	struct CountingAllocator
+	{
+		static uint32_t s_allocations;
+
+		static void* static_allocate(size_t bytes) { ++s_allocations; return operator new(bytes); }
+		static void static_deallocate(void* ptr, size_t) { operator delete(ptr); }
+	};
+
+	uint32_t CountingAllocator::s_allocations = 0;
+
+	template <class T, size_t N>
+	using counted_small_vector = stl::small_vector<T, N, CountingAllocator>;
+
+	using counted_string = stl::basic_string<CountingAllocator>;
+
+	// the first N elements are inline, the one after goes to the heap in a single allocation
+	void small_vector_allocations()
+	{
+		CountingAllocator::s_allocations = 0;
+		counted_small_vector<uint32_t, 4> values;
+		for(uint32_t i = 0; i < 4; ++i)
+			values.push_back(i);
+		MUD_CHECK(CountingAllocator::s_allocations == 0);
+
+		counted_small_vector<uint32_t, 4> copy = values;
+		counted_small_vector<uint32_t, 4> moved = move(copy);
+		MUD_CHECK(CountingAllocator::s_allocations == 0);
+
+		values.push_back(4);
+		MUD_CHECK(CountingAllocator::s_allocations == 1);
+		MUD_CHECK(values.size() == 5 && values[0] == 0 && values[4] == 4);
+		MUD_CHECK(moved.size() == 4 && moved[3] == 3);
+
+		CountingAllocator::s_allocations = 0;
+		counted_small_vector<uint32_t, 4> sized(5);
+		MUD_CHECK(CountingAllocator::s_allocations == 1);
+	}
+
+	// strings of up to 15 characters are stored inline, whether built, copied, assigned or appended
+	void string_allocations()
+	{
+		const char* text = "0123456789abcdefghij";
+		for(size_t length = 0; length <= 16; ++length)
+		{
+			CountingAllocator::s_allocations = 0;
+			counted_string built(text, length);
+			counted_string copy = built;
+			counted_string assigned;
+			assigned = copy.c_str();
+			counted_string appended;
+			for(size_t i = 0; i < length; ++i)
+				appended.push_back(text[i]);
+
+			MUD_CHECK(assigned == built && appended == built);
+			if(length <= 15)
+				MUD_CHECK(CountingAllocator::s_allocations == 0);
+			else
+				MUD_CHECK(CountingAllocator::s_allocations > 0);
+		}
+	}
+
+	// defines appended in place into a reserved string, like program_defines, allocate once whatever their count
+	counted_string defines(uint32_t options)
+	{
+		static const char* names[] = { "SKELETON", "INSTANCING", "BILLBOARD", "QNORMALS" };
+		counted_string defines;
+		defines.reserve(256);
+		for(uint32_t o = 0; o < 4; ++o)
+			if(options & (1 << o))
+			{
+				defines += names[o];
+				defines += ";";
+			}
+		defines += "MATERIAL_ALBEDO";
+		defines += "=";
+		defines += "1";
+		defines += ";";
+		return defines;
+	}
+
+	void defines_allocations()
+	{
+		for(uint32_t options = 0; options < 16; ++options)
+		{
+			CountingAllocator::s_allocations = 0;
+			counted_string result = defines(options);
+			MUD_CHECK(CountingAllocator::s_allocations == 1);
+		}
+		MUD_CHECK(defines(15) == "SKELETON;INSTANCING;BILLBOARD;QNORMALS;MATERIAL_ALBEDO=1;");
+	}
+}
+
+int main()
+{
+	small_vector_allocations();
+	string_allocations();
+	defines_allocations();
+	return mud::test::result("stl");
+}